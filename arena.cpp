@@ -0,0 +1,163 @@
+/**
+ * @file arena.cpp
+ * @author Bastien, Victor, AlexisR 
+ * @brief Implementation file for the Arena class
+ * @version 0.1
+ * @date 2024-01-16
+ * 
+ * @copyright Copyright (c) 2024
+ * 
+ */
+
+#include <cstdint>
+#include "arena.hpp"
+#include "stats.hpp"
+
+using namespace std;
+
+/**
+ * @brief Construct a new Arena::Arena object. No memory is reserved until the first allocation
+ * 
+ * @param blockSize maximum size of the blocks requested to the system
+ */
+Arena::Arena(size_t blockSize)
+{
+    this->current = nullptr;
+    this->remaining = 0;
+    this->blockSize = blockSize;
+    this->bytesUsed = 0;
+    this->objectCount = 0;
+}
+
+/**
+ * @brief Destroy the Arena::Arena object, releasing everything it holds
+ * 
+ */
+Arena::~Arena()
+{
+    release();
+}
+
+/**
+ * @brief Get a new block of at least minSize bytes. Blocks start small and double in size up to blockSize, so that small maps do not hold a whole block
+ * 
+ * @param minSize 
+ */
+void Arena::addBlock(size_t minSize)
+{
+    size_t size = this->blocks.empty() ? 4096 : this->blocks.back().second * 2;
+    size = size < this->blockSize ? size : this->blockSize;
+    size = size > minSize ? size : minSize;
+    char* block = static_cast<char*>(::operator new(size));
+    this->blocks.push_back(make_pair(block, size));
+    this->current = block;
+    this->remaining = size;
+}
+
+/**
+ * @brief Allocate from the current block, or from a new one if it is full
+ * 
+ * @param bytes 
+ * @param alignment 
+ * @return void* 
+ */
+void* Arena::do_allocate(size_t bytes, size_t alignment)
+{
+    size_t padding = (alignment - reinterpret_cast<uintptr_t>(this->current) % alignment) % alignment;
+    if (!this->current || padding + bytes > this->remaining)
+    {
+        addBlock(bytes + alignment);
+        padding = (alignment - reinterpret_cast<uintptr_t>(this->current) % alignment) % alignment;
+    }
+    void* p = this->current + padding;
+    this->current += padding + bytes;
+    this->remaining -= padding + bytes;
+    this->bytesUsed += bytes;
+    STATS_ADD(BYTES_ALLOCATED, bytes);
+    STATS_ADD(ALLOCATIONS, 1);
+    return p;
+}
+
+/**
+ * @brief Individual deallocations are ignored, the memory comes back with release()
+ * 
+ */
+void Arena::do_deallocate(void* /* p */, size_t /* bytes */, size_t /* alignment */)
+{
+}
+
+/**
+ * @brief Two arenas are only interchangeable if they are the same object
+ * 
+ */
+bool Arena::do_is_equal(const pmr::memory_resource& other) const noexcept
+{
+    return this == &other;
+}
+
+/**
+ * @brief Destroy all the objects created in the arena, in reverse order of creation, and give all the blocks back to the system
+ * 
+ */
+void Arena::release()
+{
+    for (auto it = this->finalizers.rbegin(); it != this->finalizers.rend(); ++it)
+    {
+        it->destroy(it->object);
+    }
+    this->finalizers.clear();
+    for (auto& block : this->blocks)
+    {
+        ::operator delete(block.first);
+    }
+    this->blocks.clear();
+    this->current = nullptr;
+    this->remaining = 0;
+    this->bytesUsed = 0;
+    this->objectCount = 0;
+}
+
+/**
+ * @brief Get the number of bytes handed out by the arena
+ * 
+ * @return size_t 
+ */
+size_t Arena::getBytesUsed() const
+{
+    return this->bytesUsed;
+}
+
+/**
+ * @brief Get the number of bytes held by the arena, including the unused end of the blocks
+ * 
+ * @return size_t 
+ */
+size_t Arena::getBytesReserved() const
+{
+    size_t total = 0;
+    for (const auto& block : this->blocks)
+    {
+        total += block.second;
+    }
+    return total;
+}
+
+/**
+ * @brief Get the number of blocks held by the arena
+ * 
+ * @return size_t 
+ */
+size_t Arena::getBlockCount() const
+{
+    return this->blocks.size();
+}
+
+/**
+ * @brief Get the number of objects created with create()
+ * 
+ * @return size_t 
+ */
+size_t Arena::getObjectCount() const
+{
+    return this->objectCount;
+}
@@ -0,0 +1,87 @@
+/**
+ * @file arena.hpp
+ * @author Bastien, Victor, AlexisR 
+ * @brief Header file for the Arena class
+ * @version 0.1
+ * @date 2024-01-16
+ * 
+ * @copyright Copyright (c) 2024
+ * 
+ */
+
+#include <memory_resource>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#ifndef ARENA_HPP
+#define ARENA_HPP
+
+using namespace std;
+
+/**
+ * @brief The Arena class hands out memory from large blocks by moving a pointer forward. Nothing is freed individually: all the objects and buffers of an arena are released at once by release() or by the destructor.
+ * It is also a memory_resource, so containers such as the vertices of a Polygon can allocate from it
+ * 
+ */
+class Arena : public pmr::memory_resource
+{
+    private:
+        /**
+         * @brief Destructor to run on release for an object created with create()
+         * 
+         */
+        struct Finalizer
+        {
+            void* object;
+            void (*destroy)(void* object);
+        };
+        vector<pair<char*, size_t>> blocks;
+        vector<Finalizer> finalizers;
+        char* current;
+        size_t remaining;
+        size_t blockSize;
+        size_t bytesUsed;
+        size_t objectCount;
+        void addBlock(size_t minSize);
+    protected:
+        void* do_allocate(size_t bytes, size_t alignment) override;
+        void do_deallocate(void* p, size_t bytes, size_t alignment) override;
+        bool do_is_equal(const pmr::memory_resource& other) const noexcept override;
+    public:
+        Arena(size_t blockSize = 1 << 20);
+        Arena(const Arena& a) = delete;
+        Arena& operator=(const Arena& a) = delete;
+        ~Arena();
+        template <typename C, typename... Args>
+        C* create(Args&&... args);
+        void release();
+        size_t getBytesUsed() const;
+        size_t getBytesReserved() const;
+        size_t getBlockCount() const;
+        size_t getObjectCount() const;
+};
+
+/**
+ * @brief Construct an object of class C in the arena. Its destructor is run by release(), unless it has nothing to destroy
+ * 
+ * @tparam C 
+ * @tparam Args 
+ * @param args arguments of the constructor of C
+ * @return C* 
+ */
+template <typename C, typename... Args>
+C* Arena::create(Args&&... args)
+{
+    void* memory = allocate(sizeof(C), alignof(C));
+    C* object = new (memory) C(forward<Args>(args)...);
+    if (!is_trivially_destructible<C>::value)
+    {
+        this->finalizers.push_back(Finalizer{object, [](void* o) { static_cast<C*>(o)->~C(); }});
+    }
+    this->objectCount++;
+    return object;
+}
+
+#endif // ARENA_HPP
@@ -0,0 +1,143 @@
+/**
+ * @file area_bench.cpp
+ * @author Bastien, Victor, AlexisR 
+ * @brief Microbenchmark comparing the area computation through copies of the vertices with the single pass over a VertexView
+ * @version 0.1
+ * @date 2024-01-16
+ * 
+ * @copyright Copyright (c) 2024
+ * 
+ */
+
+#include <iostream>
+#include <vector>
+#include <chrono>
+#include <cmath>
+#include "../polygon.hpp"
+#include "../geometrybuffer.hpp"
+
+using namespace std;
+
+/**
+ * @brief Area computation as it was done before the VertexView, calling getVertices() several times per vertex
+ * 
+ * @param shape 
+ * @return float 
+ */
+float areaWithCopies(const Polygon<int, float>& shape)
+{
+    float area = 0;
+    for (size_t i = 0; i < shape.getVertices().size(); i++)
+    {
+        if (i == shape.getVertices().size() - 1)
+        {
+            area += (shape.getVertices()[i].getX() * shape.getVertices()[0].getY()) - (shape.getVertices()[i].getY() * shape.getVertices()[0].getX());
+        }
+        else
+        {
+            area += (shape.getVertices()[i].getX() * shape.getVertices()[i+1].getY()) - (shape.getVertices()[i].getY() * shape.getVertices()[i+1].getX());
+        }
+    }
+    return area / 2;
+}
+
+/**
+ * @brief Area computation in a single pass over a VertexView, as done in Plot::calculateArea()
+ * 
+ * @param shape 
+ * @return float 
+ */
+float areaWithView(const Polygon<int, float>& shape)
+{
+    float area = 0;
+    VertexView<int, float> vertices = shape.getVertexView();
+    size_t n = vertices.size();
+    for (size_t i = 0; i + 1 < n; i++)
+    {
+        area += (vertices[i].getX() * vertices[i+1].getY()) - (vertices[i].getY() * vertices[i+1].getX());
+    }
+    if (n > 0)
+    {
+        area += (vertices[n-1].getX() * vertices[0].getY()) - (vertices[n-1].getY() * vertices[0].getX());
+    }
+    return area / 2;
+}
+
+/**
+ * @brief Area computation with the vectorized kernel, on a copy of the polygon stored as a structure of arrays
+ * 
+ * @param geometry 
+ * @return float 
+ */
+float areaWithKernel(const GeometryBuffer<int, float>& geometry)
+{
+    return geometry.getSignedArea(0);
+}
+
+/**
+ * @brief Build a regular polygon with n vertices, in counterclockwise order
+ * 
+ * @param n 
+ * @return Polygon<int, float> 
+ */
+Polygon<int, float> regularPolygon(int n)
+{
+    vector<Point2D<int, float>> vertices;
+    for (int i = 0; i < n; i++)
+    {
+        double angle = 2 * M_PI * i / n;
+        vertices.push_back(Point2D<int, float>(static_cast<int>(10000 * cos(angle)), static_cast<float>(static_cast<int>(10000 * sin(angle)))));
+    }
+    return Polygon<int, float>(vertices);
+}
+
+/**
+ * @brief Time one area function on a polygon, in nanoseconds per call
+ * 
+ * @param f 
+ * @param shape 
+ * @param iterations 
+ * @return double 
+ */
+double timeArea(float (*f)(const Polygon<int, float>&), const Polygon<int, float>& shape, int iterations)
+{
+    volatile float sink = 0;
+    auto start = chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++)
+    {
+        sink = sink + f(shape);
+    }
+    auto end = chrono::steady_clock::now();
+    return chrono::duration<double, nano>(end - start).count() / iterations;
+}
+
+int main()
+{
+    cout << "Geometry kernel: " << getGeometryKernelName() << endl;
+    cout << "vertices\tcopies (ns)\tview (ns)\tkernel (ns)\tspeedup" << endl;
+    for (int n : {10, 100, 1000, 10000})
+    {
+        Polygon<int, float> shape = regularPolygon(n);
+        if (areaWithCopies(shape) != areaWithView(shape))
+        {
+            cout << "Error: both area computations differ for " << n << " vertices" << endl;
+            return 1;
+        }
+        // the copying version is quadratic, so fewer iterations are needed to get a stable measure
+        int copiesIterations = n >= 10000 ? 1 : 100000 / n;
+        int viewIterations = 10000000 / n;
+        double copies = timeArea(areaWithCopies, shape, copiesIterations);
+        double view = timeArea(areaWithView, shape, viewIterations);
+        GeometryBuffer<int, float> geometry;
+        geometry.addPolygon(shape);
+        volatile float sink = 0;
+        auto start = chrono::steady_clock::now();
+        for (int i = 0; i < viewIterations; i++)
+        {
+            sink = sink + areaWithKernel(geometry);
+        }
+        double kernel = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count() / viewIterations;
+        cout << n << "\t\t" << copies << "\t\t" << view << "\t\t" << kernel << "\t\t" << copies / view << "x" << endl;
+    }
+    return 0;
+}
@@ -0,0 +1,445 @@
+/**
+ * @file bench.cpp
+ * @author Bastien, Victor, AlexisR 
+ * @brief Benchmark suite of the cadastre library, printing its results in JSON so that releases can be compared
+ * @version 0.1
+ * @date 2024-01-16
+ * 
+ * @copyright Copyright (c) 2024
+ * 
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <new>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "../parser.hpp"
+#include "../binaryformat.hpp"
+#include "../plotstore.hpp"
+#include "../map.hpp"
+#include "../lazymap.hpp"
+#include "../textwriter.hpp"
+#include "../geometrybuffer.hpp"
+#include "../geometrykernels.hpp"
+
+using namespace std;
+
+// every allocation of the program goes through these counters
+static atomic<size_t> allocationCount(0);
+static atomic<size_t> allocatedBytes(0);
+
+void* operator new(size_t size)
+{
+    allocationCount.fetch_add(1, memory_order_relaxed);
+    allocatedBytes.fetch_add(size, memory_order_relaxed);
+    if (void* p = malloc(size ? size : 1))
+    {
+        return p;
+    }
+    throw bad_alloc();
+}
+
+void operator delete(void* p) noexcept
+{
+    free(p);
+}
+
+void operator delete(void* p, size_t) noexcept
+{
+    free(p);
+}
+
+/**
+ * @brief Keep the compiler from optimizing a value away
+ * 
+ */
+template <typename T>
+inline void keep(const T& value)
+{
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+/**
+ * @brief The BenchResult struct holds the measures of one benchmark
+ * 
+ */
+struct BenchResult
+{
+    string name;
+    string unit; // what the throughput counts
+    size_t iterations;
+    double nsPerOp;
+    double throughput; // units per second
+    double allocationsPerOp;
+    double bytesPerOp;
+};
+
+/**
+ * @brief Run op in batches of increasing size until a batch lasts long enough, then time several batches and keep the median
+ * 
+ * @param name
+ * @param unit
+ * @param unitsPerOp number of units processed by one call to op
+ * @param op
+ * @return BenchResult
+ */
+BenchResult run(const string& name, const string& unit, double unitsPerOp, const function<void()>& op)
+{
+    const double minBatchNs = 5e7;
+    const int batchCount = 5;
+    size_t batch = 1;
+    for (;;)
+    {
+        auto start = chrono::steady_clock::now();
+        for (size_t i = 0; i < batch; i++)
+        {
+            op();
+        }
+        double ns = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count();
+        if (ns >= minBatchNs || batch >= (size_t(1) << 30))
+        {
+            break;
+        }
+        batch = ns < minBatchNs / 100 ? batch * 10 : static_cast<size_t>(batch * minBatchNs / ns) + 1;
+    }
+
+    vector<double> times;
+    size_t allocations = allocationCount.load();
+    size_t bytes = allocatedBytes.load();
+    for (int b = 0; b < batchCount; b++)
+    {
+        auto start = chrono::steady_clock::now();
+        for (size_t i = 0; i < batch; i++)
+        {
+            op();
+        }
+        times.push_back(chrono::duration<double, nano>(chrono::steady_clock::now() - start).count() / batch);
+    }
+    size_t ops = batch * batchCount;
+    sort(times.begin(), times.end());
+
+    BenchResult result;
+    result.name = name;
+    result.unit = unit;
+    result.iterations = ops;
+    result.nsPerOp = times[batchCount / 2];
+    result.throughput = unitsPerOp * 1e9 / result.nsPerOp;
+    result.allocationsPerOp = static_cast<double>(allocationCount.load() - allocations) / ops;
+    result.bytesPerOp = static_cast<double>(allocatedBytes.load() - bytes) / ops;
+    cerr << name << ": " << result.nsPerOp << " ns/op" << endl;
+    return result;
+}
+
+/**
+ * @brief Print the results as a JSON document
+ * 
+ */
+void printJson(ostream& os, const vector<BenchResult>& results, size_t plotCount)
+{
+    os << "{\n";
+    os << "  \"suite\": \"cadastre\",\n";
+    os << "  \"compiler\": \"" << __VERSION__ << "\",\n";
+    os << "  \"geometry_kernel\": \"" << getGeometryKernelName() << "\",\n";
+    os << "  \"plots\": " << plotCount << ",\n";
+    os << "  \"results\": [\n";
+    for (size_t i = 0; i < results.size(); i++)
+    {
+        const BenchResult& r = results[i];
+        os << "    {\"name\": \"" << r.name << "\", \"iterations\": " << r.iterations
+           << ", \"ns_per_op\": " << r.nsPerOp
+           << ", \"throughput\": " << r.throughput << ", \"throughput_unit\": \"" << r.unit << "/s\""
+           << ", \"allocations_per_op\": " << r.allocationsPerOp
+           << ", \"bytes_allocated_per_op\": " << r.bytesPerOp << "}" << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    os << "  ]\n";
+    os << "}" << endl;
+}
+
+/**
+ * @brief Build a regular polygon, its vertices being rounded to integer x
+ * 
+ */
+Polygon<int, float> regularPolygon(int n, int radius)
+{
+    vector<Point2D<int, float>> vertices;
+    for (int i = 0; i < n; i++)
+    {
+        double angle = 2 * M_PI * i / n;
+        vertices.push_back(Point2D<int, float>(static_cast<int>(radius * cos(angle)), static_cast<float>(radius * sin(angle))));
+    }
+    return Polygon<int, float>(vertices);
+}
+
+/**
+ * @brief Vertices of a long strip with a zigzag edge: its first edge crosses the whole strip, but each appended vertex only makes edges overlapping a few others in x
+ * 
+ * @param n number of vertices
+ * @return vector<Point2D<int, float>> 
+ */
+vector<Point2D<int, float>> stripVertices(int n)
+{
+    vector<Point2D<int, float>> vertices = {Point2D<int, float>(100 * 2 * n, 0)};
+    for (int i = 1; i < n; i++)
+    {
+        vertices.push_back(Point2D<int, float>(100 * i, static_cast<float>(100 + 100 * ((i + 1) % 2))));
+    }
+    return vertices;
+}
+
+/**
+ * @brief Delete the plots created with new by loadPlots() or binaryToPlots(), and their shapes
+ * 
+ */
+void deletePlots(vector<Plot*>& plots)
+{
+    for (auto plot : plots)
+    {
+        delete plot->getShape();
+        delete plot;
+    }
+    plots.clear();
+}
+
+int main(int argc, char* argv[])
+{
+    string source = argc > 1 ? argv[1] : "./plots/plots.txt";
+    int copies = argc > 2 ? atoi(argv[2]) : 200;
+    string output = argc > 3 ? argv[3] : "";
+    const string textFile = "./plots/bench.txt";
+    const string binaryFile = "./plots/bench.bin";
+    const string textOutputFile = "./plots/bench_out.txt";
+    const string journalFile = "./plots/bench.log";
+
+    // build a larger text file by repeating the source
+    ifstream in(source);
+    if (!in.is_open())
+    {
+        cout << "Unable to open file" << endl;
+        return 1;
+    }
+    stringstream content;
+    content << in.rdbuf();
+    string text = content.str();
+    if (!text.empty() && text.back() != '\n')
+    {
+        text += '\n';
+    }
+    ofstream out(textFile);
+    for (int i = 0; i < copies; i++)
+    {
+        out << text;
+    }
+    out.close();
+
+    vector<BenchResult> results;
+
+    // Polygon area
+    for (int n : {16, 1024})
+    {
+        Polygon<int, float> shape = regularPolygon(n, 100000);
+        GeometryBuffer<int, float> geometry;
+        geometry.addPolygon(shape);
+        results.push_back(run("polygon_area_shoelace_" + to_string(n), "vertices", n, [&]() {
+            keep(geometry.getSignedArea(0));
+        }));
+        results.push_back(run("polygon_area_cached_" + to_string(n), "polygons", 1, [&]() {
+            keep(shape.getSignedArea());
+        }));
+        vector<Point2D<int, float>> vertices = shape.getVertices();
+        results.push_back(run("polygon_set_vertices_" + to_string(n), "vertices", n, [&]() {
+            shape.setVertices(vertices); // validation and area
+        }));
+        results.push_back(run("polygon_add_vertex_" + to_string(n), "vertices", n, [&]() {
+            Polygon<int, float> built;
+            for (const auto& vertex : vertices)
+            {
+                built.addVertex(vertex);
+            }
+            keep(built.getSignedArea());
+        }));
+        vector<Point2D<int, float>> strip = stripVertices(n);
+        results.push_back(run("polygon_add_vertex_strip_" + to_string(n), "vertices", n, [&]() {
+            Polygon<int, float> built;
+            for (const auto& vertex : strip)
+            {
+                built.addVertex(vertex);
+            }
+            keep(built.getSignedArea());
+        }));
+        results.push_back(run("polygon_edit_batch_" + to_string(n), "vertices", n, [&]() {
+            Polygon<int, float> built;
+            PolygonEditor<int, float> editor = built.edit();
+            editor.reserve(vertices.size());
+            for (const auto& vertex : vertices)
+            {
+                editor.addVertex(vertex);
+            }
+            editor.commit();
+            keep(built.getSignedArea());
+        }));
+    }
+
+    // file load and save
+    vector<Plot*> plots = loadPlots(textFile);
+    size_t plotCount = plots.size();
+    plotsToBinary(plots, binaryFile);
+    results.push_back(run("load_text", "plots", plotCount, [&]() {
+        vector<Plot*> loaded = loadPlots(textFile);
+        deletePlots(loaded);
+    }));
+    results.push_back(run("load_text_parallel", "plots", plotCount, [&]() {
+        vector<Plot*> loaded = loadPlotsParallel(textFile);
+        deletePlots(loaded);
+    }));
+    results.push_back(run("load_binary", "plots", plotCount, [&]() {
+        vector<Plot*> loaded = binaryToPlots(binaryFile);
+        deletePlots(loaded);
+    }));
+    results.push_back(run("load_plot_store", "plots", plotCount, [&]() {
+        PlotStore store(textFile);
+        keep(store.size());
+    }));
+    results.push_back(run("load_map", "plots", plotCount, [&]() {
+        Map loaded(textFile); // parsing and validation, with a single self-intersection check per plot
+        keep(loaded.getPlots().size());
+    }));
+    results.push_back(run("save_binary", "plots", plotCount, [&]() {
+        plotsToBinary(plots, binaryFile);
+    }));
+    results.push_back(run("lazy_open_scan", "plots", plotCount, [&]() {
+        LazyMap lazy(textFile);
+        keep(lazy.getPlotCount());
+    }));
+    {
+        LazyMap indexed(textFile);
+        indexed.saveIndex();
+        results.push_back(run("lazy_open_index", "plots", plotCount, [&]() {
+            LazyMap lazy(textFile);
+            keep(lazy.getPlotCount());
+        }));
+        remove(indexed.getIndexFilename().c_str());
+        LazyMap lazy(textFile, 1024); // the copies of the source repeat its numbers, so the plots asked for stay resident
+        size_t next = 0;
+        results.push_back(run("lazy_get_plot_resident", "plots", 1, [&]() {
+            keep(lazy.getPlot(plots[next++ % plotCount]->getNumber()));
+        }));
+    }
+    Map map(textFile);
+    cerr << "map_string_memory: " << map.getStringMemory() << " bytes interned, " << map.getUninternedStringMemory() << " bytes as separate strings" << endl;
+    results.push_back(run("map_aggregate", "plots", plotCount, [&]() {
+        MapAggregates totals = map.aggregate();
+        keep(totals.total.plotCount);
+    }));
+    results.push_back(run("map_validate", "plots", plotCount, [&]() {
+        ValidationReport report = map.validate();
+        keep(report.invalidPlotCount);
+    }));
+    {
+        Map journaled;
+        journaled.open(textFile, journalFile);
+        journaled.setCompactionThreshold(0);
+        int number = journaled.getPlots()[0]->getNumber();
+        const string owners[] = {"AMPLOI", "Victor"};
+        size_t edits = 0;
+        results.push_back(run("map_edit_journaled", "edits", 1, [&]() {
+            journaled.setPlotOwner(number, owners[edits++ & 1]); // one line appended, whatever the size of the map
+        }));
+    }
+    PlotStore store(textFile);
+    results.push_back(run("save_text", "plots", plotCount, [&]() {
+        ostringstream os;
+        store.writeText(os);
+        keep(os.tellp());
+    }));
+    results.push_back(run("save_text_buffered", "plots", plotCount, [&]() {
+        writePlotsText(store, textOutputFile);
+    }));
+    deletePlots(plots);
+
+    // Plot construction, on a shape that is never modified afterwards
+    {
+        const int plotsPerOp = 256;
+        Polygon<int, float> shape = regularPolygon(8, 1000);
+        results.push_back(run("construct_urban_zone", "plots", plotsPerOp, [&]() {
+            Polygon<int, float> owned(shape);
+            for (int i = 0; i < plotsPerOp; i++)
+            {
+                UrbanZone plot(i, "AMPLOI", &owned, 50, 100);
+                keep(plot.getArea());
+            }
+        }));
+        results.push_back(run("construct_zone_to_be_urbanized", "plots", plotsPerOp, [&]() {
+            Polygon<int, float> owned(shape);
+            for (int i = 0; i < plotsPerOp; i++)
+            {
+                ZoneToBeUrbanized plot(i, "AMPLOI", &owned, 50);
+                keep(plot.getArea());
+            }
+        }));
+        results.push_back(run("construct_natural_and_forest_zone", "plots", plotsPerOp, [&]() {
+            Polygon<int, float> owned(shape);
+            for (int i = 0; i < plotsPerOp; i++)
+            {
+                NaturalAndForestZone plot(i, "AMPLOI", &owned);
+                keep(plot.getArea());
+            }
+        }));
+        results.push_back(run("construct_agricultural_zone", "plots", plotsPerOp, [&]() {
+            Polygon<int, float> owned(shape);
+            for (int i = 0; i < plotsPerOp; i++)
+            {
+                AgriculturalZone plot(i, "AMPLOI", &owned, "Wheat");
+                keep(plot.getArea());
+            }
+        }));
+    }
+
+    // cost of a shape change read back by 0, 1 or 8 plots, each recomputing its area lazily
+    for (int readers : {0, 1, 8})
+    {
+        Polygon<int, float> shape = regularPolygon(8, 1000);
+        vector<NaturalAndForestZone> plots;
+        for (int i = 0; i < readers; i++)
+        {
+            plots.emplace_back(i, "AMPLOI", &shape);
+        }
+        Point2D<int, float> vertex = shape.getVertexView()[0];
+        results.push_back(run("shape_change_read_by_" + to_string(readers), "changes", 1, [&]() {
+            shape.setVertex(0, vertex);
+            for (const auto& plot : plots)
+            {
+                keep(plot.getArea());
+            }
+        }));
+    }
+
+    remove(textFile.c_str());
+    remove(binaryFile.c_str());
+    remove(textOutputFile.c_str());
+    remove(journalFile.c_str());
+
+    if (output.empty())
+    {
+        printJson(cout, results, plotCount);
+    }
+    else
+    {
+        ofstream json(output);
+        if (!json.is_open())
+        {
+            cout << "Unable to open file" << endl;
+            return 1;
+        }
+        printJson(json, results, plotCount);
+    }
+    return 0;
+}
@@ -0,0 +1,70 @@
+/**
+ * @file format_bench.cpp
+ * @author Bastien, Victor, AlexisR 
+ * @brief Benchmark comparing the loading of the text format with the loading of the binary format
+ * @version 0.1
+ * @date 2024-01-16
+ * 
+ * @copyright Copyright (c) 2024
+ * 
+ */
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <chrono>
+#include <cstdio>
+#include "../parser.hpp"
+#include "../binaryformat.hpp"
+
+using namespace std;
+
+/**
+ * @brief Time a function, in milliseconds
+ * 
+ */
+template <typename F>
+double timeMs(F f)
+{
+    auto start = chrono::steady_clock::now();
+    f();
+    return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char* argv[])
+{
+    string source = argc > 1 ? argv[1] : "./plots/plots.txt";
+    int copies = argc > 2 ? atoi(argv[2]) : 2000;
+    const string textFile = "./plots/format_bench.txt";
+    const string binaryFile = "./plots/format_bench.bin";
+
+    // build a larger text file by repeating the source
+    ifstream in(source);
+    stringstream content;
+    content << in.rdbuf();
+    string text = content.str();
+    if (!text.empty() && text.back() != '\n')
+    {
+        text += '\n';
+    }
+    ofstream out(textFile);
+    for (int i = 0; i < copies; i++)
+    {
+        out << text;
+    }
+    out.close();
+
+    vector<Plot*> plots;
+    double textLoad = timeMs([&]() { plots = loadPlots(textFile); });
+    double binarySave = timeMs([&]() { plotsToBinary(plots, binaryFile); });
+    vector<Plot*> binaryPlots;
+    double binaryLoad = timeMs([&]() { binaryPlots = binaryToPlots(binaryFile); });
+
+    cout << "plots: " << plots.size() << endl;
+    cout << "text load: " << textLoad << " ms" << endl;
+    cout << "binary save: " << binarySave << " ms" << endl;
+    cout << "binary load: " << binaryLoad << " ms (" << textLoad / binaryLoad << "x faster)" << endl;
+    remove(textFile.c_str());
+    remove(binaryFile.c_str());
+    return plots.size() == binaryPlots.size() ? 0 : 1;
+}
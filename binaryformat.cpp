@@ -0,0 +1,237 @@
+/**
+ * @file binaryformat.cpp
+ * @author Bastien, Victor, AlexisR 
+ * @brief Implementation file for the binary cadastre format
+ * @version 0.1
+ * @date 2024-01-16
+ * 
+ * @copyright Copyright (c) 2024
+ * 
+ */
+
+#include <cstring>
+#include <fstream>
+#include <unordered_map>
+#include "binaryformat.hpp"
+#include "parser.hpp"
+
+using namespace std;
+
+/**
+ * @brief The StringTable struct collects the strings of the file, each distinct string being stored only once
+ * 
+ */
+struct StringTable
+{
+    string data;
+    unordered_map<string, uint32_t> offsets;
+
+    uint32_t add(const string& s)
+    {
+        auto it = offsets.find(s);
+        if (it != offsets.end())
+        {
+            return it->second;
+        }
+        uint32_t offset = static_cast<uint32_t>(data.size());
+        data += s;
+        offsets.emplace(s, offset);
+        return offset;
+    }
+};
+
+/**
+ * @brief The BinaryWriter struct collects the tables of a binary file plot by plot, then writes the file
+ * 
+ */
+struct BinaryWriter
+{
+    vector<BinaryPlotRecord> records;
+    vector<BinaryVertex> vertices;
+    StringTable strings;
+
+    BinaryPlotRecord& add(const Plot& plot)
+    {
+        BinaryPlotRecord record = {};
+        record.number = plot.getNumber();
+        record.type = static_cast<uint32_t>(plot.getType());
+        record.pBuildable = plot.getPBuildable();
+        const string& owner = plot.getOwner();
+        record.ownerOffset = strings.add(owner);
+        record.ownerLength = static_cast<uint32_t>(owner.size());
+        record.firstVertex = vertices.size();
+        for (const auto& vertex : plot.getShape()->getVertexView())
+        {
+            vertices.push_back(BinaryVertex{vertex.getX(), vertex.getY()});
+        }
+        record.vertexCount = vertices.size() - record.firstVertex;
+        records.push_back(record);
+        return records.back();
+    }
+
+    void add(const UrbanZone& plot)
+    {
+        add(static_cast<const Plot&>(plot)).builtArea = plot.getBuiltArea();
+    }
+
+    void add(const AgriculturalZone& plot)
+    {
+        BinaryPlotRecord& record = add(static_cast<const Plot&>(plot));
+        const string& crop = plot.getCropType();
+        record.cropOffset = strings.add(crop);
+        record.cropLength = static_cast<uint32_t>(crop.size());
+    }
+
+    bool write(const string& filename) const;
+};
+
+bool BinaryWriter::write(const string& filename) const
+{
+    BinaryHeader header = {};
+    memcpy(header.magic, BINARY_MAGIC, sizeof(header.magic));
+    header.version = BINARY_VERSION;
+    header.byteOrder = BINARY_BYTE_ORDER;
+    header.plotCount = records.size();
+    header.vertexCount = vertices.size();
+    header.stringTableSize = strings.data.size();
+    header.recordsOffset = sizeof(BinaryHeader);
+    header.stringsOffset = header.recordsOffset + records.size() * sizeof(BinaryPlotRecord);
+    // the vertex blob is aligned on 8 bytes so that it can be read in place
+    header.verticesOffset = (header.stringsOffset + strings.data.size() + 7) / 8 * 8;
+
+    ofstream file(filename, ios::binary | ios::trunc);
+    if (!file.is_open())
+    {
+        cout << "Unable to open file" << endl;
+        return false;
+    }
+    const char padding[8] = {};
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(records.data()), records.size() * sizeof(BinaryPlotRecord));
+    file.write(strings.data.data(), strings.data.size());
+    file.write(padding, header.verticesOffset - header.stringsOffset - strings.data.size());
+    file.write(reinterpret_cast<const char*>(vertices.data()), vertices.size() * sizeof(BinaryVertex));
+    return file.good();
+}
+
+bool plotsToBinary(const vector<Plot*>& plots, const string& filename)
+{
+    STATS_TIME(SAVE_BINARY);
+    BinaryWriter writer;
+    writer.records.reserve(plots.size());
+    for (auto plot : plots)
+    {
+        switch (plot->getType())
+        {
+            case PlotType::URBAN_ZONE:
+                writer.add(*dynamic_cast<UrbanZone*>(plot));
+                break;
+            case PlotType::AGRICULTURAL_ZONE:
+                writer.add(*dynamic_cast<AgriculturalZone*>(plot));
+                break;
+            default:
+                writer.add(*plot);
+                break;
+        }
+    }
+    return writer.write(filename);
+}
+
+bool plotsToBinary(const PlotStore& store, const string& filename)
+{
+    STATS_TIME(SAVE_BINARY);
+    BinaryWriter writer;
+    writer.records.reserve(store.size());
+    store.forEachPlot([&writer](const auto& plot) { writer.add(plot); });
+    return writer.write(filename);
+}
+
+/**
+ * @brief Check that the header describes tables lying inside the file
+ * 
+ */
+static bool isValidHeader(const BinaryHeader& header, size_t fileSize)
+{
+    if (memcmp(header.magic, BINARY_MAGIC, sizeof(header.magic)) != 0 || header.version != BINARY_VERSION || header.byteOrder != BINARY_BYTE_ORDER)
+    {
+        return false;
+    }
+    return header.recordsOffset <= fileSize && header.plotCount <= (fileSize - header.recordsOffset) / sizeof(BinaryPlotRecord)
+        && header.stringsOffset <= fileSize && header.stringTableSize <= fileSize - header.stringsOffset
+        && header.verticesOffset <= fileSize && header.vertexCount <= (fileSize - header.verticesOffset) / sizeof(BinaryVertex)
+        && header.recordsOffset % alignof(BinaryPlotRecord) == 0 && header.verticesOffset % alignof(BinaryVertex) == 0;
+}
+
+vector<Plot*> binaryToPlots(const string& filename)
+{
+    STATS_TIME(LOAD_BINARY);
+    vector<Plot*> plots;
+    MappedFile file(filename);
+    if (!file.isOpen())
+    {
+        cout << "Unable to open file" << endl;
+        return plots;
+    }
+    BinaryHeader header;
+    if (file.getSize() < sizeof(header))
+    {
+        cout << "Invalid binary cadastre file" << endl;
+        return plots;
+    }
+    memcpy(&header, file.begin(), sizeof(header));
+    if (!isValidHeader(header, file.getSize()))
+    {
+        cout << "Invalid binary cadastre file" << endl;
+        return plots;
+    }
+    const BinaryPlotRecord* records = reinterpret_cast<const BinaryPlotRecord*>(file.begin() + header.recordsOffset);
+    const char* strings = file.begin() + header.stringsOffset;
+    const BinaryVertex* blob = reinterpret_cast<const BinaryVertex*>(file.begin() + header.verticesOffset);
+
+    plots.reserve(header.plotCount);
+    for (uint64_t i = 0; i < header.plotCount; i++)
+    {
+        const BinaryPlotRecord& record = records[i];
+        if (record.firstVertex > header.vertexCount || record.vertexCount > header.vertexCount - record.firstVertex
+            || record.ownerOffset + static_cast<uint64_t>(record.ownerLength) > header.stringTableSize
+            || record.cropOffset + static_cast<uint64_t>(record.cropLength) > header.stringTableSize)
+        {
+            cout << "Invalid binary cadastre file" << endl;
+            // nothing is returned for a broken file, the plots read so far are released with their shapes
+            for (auto plot : plots)
+            {
+                delete plot->getShape();
+                delete plot;
+            }
+            plots.clear();
+            return plots;
+        }
+        pmr::vector<Point2D<int, float>> vertices(STATS_RESOURCE());
+        vertices.reserve(record.vertexCount);
+        for (uint64_t v = record.firstVertex; v < record.firstVertex + record.vertexCount; v++)
+        {
+            vertices.emplace_back(blob[v].x, blob[v].y);
+        }
+        Polygon<int, float>* shape = new Polygon<int, float>(move(vertices), false); // not checked for self-intersections, see validatePlots()
+        string_view owner(strings + record.ownerOffset, record.ownerLength);
+        switch (record.type)
+        {
+            case PlotType::URBAN_ZONE:
+                plots.push_back(new UrbanZone(record.number, owner, shape, record.pBuildable, record.builtArea, false));
+                break;
+            case PlotType::ZONE_TO_BE_URBANIZED:
+                plots.push_back(new ZoneToBeUrbanized(record.number, owner, shape, record.pBuildable));
+                break;
+            case PlotType::NATURAL_AND_FOREST_ZONE:
+                plots.push_back(new NaturalAndForestZone(record.number, owner, shape));
+                break;
+            case PlotType::AGRICULTURAL_ZONE:
+                plots.push_back(new AgriculturalZone(record.number, owner, shape, string_view(strings + record.cropOffset, record.cropLength)));
+                break;
+            default:
+                delete shape;
+                break;
+        }
+    }
+    return plots;
+}
@@ -0,0 +1,107 @@
+/**
+ * @file binaryformat.hpp
+ * @author Bastien, Victor, AlexisR 
+ * @brief Header file for the binary cadastre format
+ * @version 0.1
+ * @date 2024-01-16
+ * 
+ * @copyright Copyright (c) 2024
+ * 
+ */
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "plot.hpp"
+#include "plotstore.hpp"
+
+#ifndef BINARYFORMAT_HPP
+#define BINARYFORMAT_HPP
+
+using namespace std;
+
+/**
+ * @brief Layout of a binary cadastre file, all integers in the byte order of the machine that wrote it:
+ * - a BinaryHeader
+ * - plotCount BinaryPlotRecord
+ * - the string table: owners and crop types, each stored once, without separators
+ * - vertexCount BinaryVertex, the vertices of all the plots one after the other
+ * 
+ */
+const char BINARY_MAGIC[4] = {'C', 'A', 'D', 'B'};
+const uint32_t BINARY_VERSION = 1;
+const uint32_t BINARY_BYTE_ORDER = 0x01020304;
+
+/**
+ * @brief Header at the start of a binary cadastre file. The offsets are in bytes from the start of the file
+ * 
+ */
+struct BinaryHeader
+{
+    char magic[4];
+    uint32_t version;
+    uint32_t byteOrder;
+    uint32_t reserved;
+    uint64_t plotCount;
+    uint64_t vertexCount;
+    uint64_t stringTableSize;
+    uint64_t recordsOffset;
+    uint64_t stringsOffset;
+    uint64_t verticesOffset;
+};
+
+/**
+ * @brief Fixed-size description of one plot. Strings are (offset, length) in the string table, vertices are a range of the vertex blob
+ * 
+ */
+struct BinaryPlotRecord
+{
+    int32_t number;
+    uint32_t type; // PlotType
+    int32_t pBuildable;
+    float builtArea;
+    uint32_t ownerOffset;
+    uint32_t ownerLength;
+    uint32_t cropOffset;
+    uint32_t cropLength;
+    uint64_t firstVertex;
+    uint64_t vertexCount;
+};
+
+/**
+ * @brief One vertex of the vertex blob
+ * 
+ */
+struct BinaryVertex
+{
+    int32_t x;
+    float y;
+};
+
+/**
+ * @brief Save plots to a binary cadastre file
+ * 
+ * @param plots 
+ * @param filename 
+ * @return bool false if the file could not be written
+ */
+bool plotsToBinary(const vector<Plot*>& plots, const string& filename);
+
+/**
+ * @brief Save the plots of a store to a binary cadastre file, in file order. Gives the same file as plotsToBinary() on the same plots
+ * 
+ * @param store 
+ * @param filename 
+ * @return bool false if the file could not be written
+ */
+bool plotsToBinary(const PlotStore& store, const string& filename);
+
+/**
+ * @brief Load plots from a binary cadastre file. The file is mapped in memory and its tables are read in place
+ * 
+ * @param filename 
+ * @return vector<Plot*> empty if the file cannot be opened or is not a valid binary cadastre
+ */
+vector<Plot*> binaryToPlots(const string& filename);
+
+#endif // BINARYFORMAT_HPP
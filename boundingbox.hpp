@@ -0,0 +1,63 @@
+/**
+ * @file boundingbox.hpp
+ * @author Bastien, Victor, AlexisR 
+ * @brief Header file for the BoundingBox struct
+ * @version 0.1
+ * @date 2024-01-16
+ * 
+ * @copyright Copyright (c) 2024
+ * 
+ */
+
+#include <iostream>
+#include <limits>
+
+#ifndef BOUNDINGBOX_HPP
+#define BOUNDINGBOX_HPP
+
+using namespace std;
+
+/**
+ * @brief The BoundingBox struct is an axis-aligned rectangle. A default constructed box is empty and grows with expand()
+ * 
+ */
+struct BoundingBox
+{
+    double minX = numeric_limits<double>::infinity();
+    double minY = numeric_limits<double>::infinity();
+    double maxX = -numeric_limits<double>::infinity();
+    double maxY = -numeric_limits<double>::infinity();
+
+    BoundingBox() {}
+    BoundingBox(double minX, double minY, double maxX, double maxY) : minX(minX), minY(minY), maxX(maxX), maxY(maxY) {}
+
+    bool isEmpty() const { return minX > maxX || minY > maxY; }
+    bool contains(double x, double y) const { return x >= minX && x <= maxX && y >= minY && y <= maxY; }
+    bool intersects(const BoundingBox& b) const { return minX <= b.maxX && b.minX <= maxX && minY <= b.maxY && b.minY <= maxY; }
+    double getCenterX() const { return (minX + maxX) / 2; }
+    double getCenterY() const { return (minY + maxY) / 2; }
+
+    void expand(double x, double y)
+    {
+        minX = x < minX ? x : minX;
+        minY = y < minY ? y : minY;
+        maxX = x > maxX ? x : maxX;
+        maxY = y > maxY ? y : maxY;
+    }
+
+    void expand(const BoundingBox& b)
+    {
+        minX = b.minX < minX ? b.minX : minX;
+        minY = b.minY < minY ? b.minY : minY;
+        maxX = b.maxX > maxX ? b.maxX : maxX;
+        maxY = b.maxY > maxY ? b.maxY : maxY;
+    }
+
+    friend ostream& operator<<(ostream& os, const BoundingBox& b)
+    {
+        os << "[(" << b.minX << ", " << b.minY << "), (" << b.maxX << ", " << b.maxY << ")]";
+        return os;
+    }
+};
+
+#endif // BOUNDINGBOX_HPP
@@ -0,0 +1,478 @@
+/**
+ * @file concurrentmap.cpp
+ * @author Bastien, Victor, AlexisR 
+ * @brief Implementation file for the ConcurrentMap class
+ * @version 0.1
+ * @date 2024-01-16
+ * 
+ * @copyright Copyright (c) 2024
+ * 
+ */
+
+#include <functional>
+#include <limits>
+#include <stdexcept>
+#include <thread>
+#include "concurrentmap.hpp"
+#include "parser.hpp"
+
+using namespace std;
+
+/**
+ * @brief Construct a new MapSnapshot::MapSnapshot object from its plots, and index them
+ * 
+ * @param version 
+ * @param owners 
+ */
+MapSnapshot::MapSnapshot(uint64_t version, vector<shared_ptr<const Plot>> owners) : version(version), owners(move(owners))
+{
+    this->plots.reserve(this->owners.size());
+    this->numbers.reserve(this->owners.size());
+    vector<pair<BoundingBox, const Plot*>> items;
+    items.reserve(this->owners.size());
+    for (const auto& plot : this->owners)
+    {
+        this->numbers.emplace(plot->getNumber(), this->plots.size());
+        this->plots.push_back(plot.get());
+        items.push_back(make_pair(plot->getShape()->getBoundingBox(), plot.get()));
+    }
+    this->index.build(move(items));
+}
+
+/**
+ * @brief Get the version of the snapshot, incremented by each publication
+ * 
+ * @return uint64_t 
+ */
+uint64_t MapSnapshot::getVersion() const
+{
+    return this->version;
+}
+
+/**
+ * @brief Get the number of plots of the snapshot
+ * 
+ * @return size_t 
+ */
+size_t MapSnapshot::getPlotCount() const
+{
+    return this->plots.size();
+}
+
+/**
+ * @brief Get the plots of the snapshot
+ * 
+ * @return const vector<const Plot*>& 
+ */
+const vector<const Plot*>& MapSnapshot::getPlots() const
+{
+    return this->plots;
+}
+
+/**
+ * @brief Find a plot by number
+ * 
+ * @param number 
+ * @return const Plot* nullptr if there is no such plot 
+ */
+const Plot* MapSnapshot::findPlot(int number) const
+{
+    auto it = this->numbers.find(number);
+    return it == this->numbers.end() ? nullptr : this->plots[it->second];
+}
+
+/**
+ * @brief Find the plot containing the point (x, y), see Map::findPlotAt()
+ * 
+ * @param x 
+ * @param y 
+ * @return const Plot* nullptr if the point is outside every plot 
+ */
+const Plot* MapSnapshot::findPlotAt(double x, double y) const
+{
+    const Plot* found = nullptr;
+    this->index.searchPoint(x, y, [&](const Plot* plot) {
+        if (!found && plot->getShape()->contains(x, y))
+        {
+            found = plot;
+        }
+    });
+    return found;
+}
+
+/**
+ * @brief Find the plots whose bounding box intersects a box
+ * 
+ * @param box 
+ * @return vector<const Plot*> 
+ */
+vector<const Plot*> MapSnapshot::findPlotsIn(const BoundingBox& box) const
+{
+    vector<const Plot*> found;
+    this->index.search(box, [&](const Plot* plot) { found.push_back(plot); });
+    return found;
+}
+
+/**
+ * @brief Compute the totals of the snapshot, see aggregatePlots()
+ * 
+ * @param threadCount number of threads, 0 for one per core 
+ * @return MapAggregates 
+ */
+MapAggregates MapSnapshot::aggregate(unsigned threadCount) const
+{
+    return aggregatePlots(this->plots.data(), this->plots.size(), threadCount);
+}
+
+/**
+ * @brief Construct a new MapReadGuard::MapReadGuard object: take a free slot, write the current epoch in it, then read the current snapshot.
+ * A writer seeing the slot keeps every snapshot retired at this epoch or later; a writer not seeing it yet has already published the snapshot read here
+ * 
+ * @param map 
+ */
+MapReadGuard::MapReadGuard(const ConcurrentMap* map) : map(map)
+{
+    size_t start = hash<thread::id>()(this_thread::get_id()) % ConcurrentMap::MAX_READERS;
+    for (size_t k = 0; k < ConcurrentMap::MAX_READERS; k++)
+    {
+        size_t i = (start + k) % ConcurrentMap::MAX_READERS;
+        bool expected = false;
+        if (!map->readers[i].used.load(memory_order_relaxed) && map->readers[i].used.compare_exchange_strong(expected, true))
+        {
+            this->slot = i;
+            map->readers[i].epoch.store(map->epoch.load());
+            this->snapshot = map->current.load();
+            return;
+        }
+    }
+    throw runtime_error("Too many readers of the map");
+}
+
+/**
+ * @brief Construct a new MapReadGuard::MapReadGuard object taking over the slot of another guard
+ * 
+ * @param g 
+ */
+MapReadGuard::MapReadGuard(MapReadGuard&& g) : map(g.map), slot(g.slot), snapshot(g.snapshot)
+{
+    g.map = nullptr;
+}
+
+/**
+ * @brief Destroy the MapReadGuard::MapReadGuard object, freeing its slot. The snapshot may be deleted from then on
+ * 
+ */
+MapReadGuard::~MapReadGuard()
+{
+    if (this->map)
+    {
+        this->map->readers[this->slot].epoch.store(0, memory_order_release);
+        this->map->readers[this->slot].used.store(false, memory_order_release);
+    }
+}
+
+/**
+ * @brief Construct a new MapEditor::MapEditor object, waiting for the other editors to finish
+ * 
+ * @param map 
+ */
+MapEditor::MapEditor(ConcurrentMap* map) : map(map), lock(map->writer)
+{
+    this->base = map->current.load();
+    this->committed = false;
+}
+
+/**
+ * @brief Get the position of a plot in the base snapshot. Throws an exception if there is no such plot
+ * 
+ */
+size_t MapEditor::indexOf(int number) const
+{
+    auto it = this->base->numbers.find(number);
+    if (it == this->base->numbers.end())
+    {
+        throw runtime_error("No plot number " + to_string(number));
+    }
+    return it->second;
+}
+
+/**
+ * @brief Set the new version of the plot at position i
+ * 
+ */
+void MapEditor::replace(size_t i, Plot* plot)
+{
+    this->changes[i] = shared_ptr<const Plot>(plot);
+}
+
+/**
+ * @brief Get a plot as edited so far
+ * 
+ * @param number 
+ * @return const Plot& 
+ */
+const Plot& MapEditor::getPlot(int number) const
+{
+    size_t i = indexOf(number);
+    auto it = this->changes.find(i);
+    return it == this->changes.end() ? *this->base->plots[i] : *it->second;
+}
+
+/**
+ * @brief Build a plot of a given type from the number, owner and percentage of buildable area of another plot
+ * 
+ */
+static Plot* makePlot(PlotType type, const Plot& from, Polygon<int, float>&& shape, float builtArea, const string& cropType)
+{
+    switch (type)
+    {
+        case PlotType::URBAN_ZONE:
+            return new UrbanZone(from.getNumber(), from.getOwner(), move(shape), from.getPBuildable(), builtArea, false);
+        case PlotType::ZONE_TO_BE_URBANIZED:
+            return new ZoneToBeUrbanized(from.getNumber(), from.getOwner(), move(shape), from.getPBuildable());
+        case PlotType::NATURAL_AND_FOREST_ZONE:
+            return new NaturalAndForestZone(from.getNumber(), from.getOwner(), move(shape));
+        default:
+            return new AgriculturalZone(from.getNumber(), from.getOwner(), move(shape), cropType);
+    }
+}
+
+/**
+ * @brief Get the built area of a plot, 0 if it is not an urban zone
+ * 
+ */
+static float builtAreaOf(const Plot& plot)
+{
+    return plot.getType() == PlotType::URBAN_ZONE ? dynamic_cast<const UrbanZone&>(plot).getBuiltArea() : 0;
+}
+
+/**
+ * @brief Get the crop type of a plot, empty if it is not an agricultural zone
+ * 
+ */
+static string cropTypeOf(const Plot& plot)
+{
+    return plot.getType() == PlotType::AGRICULTURAL_ZONE ? dynamic_cast<const AgriculturalZone&>(plot).getCropType() : "";
+}
+
+/**
+ * @brief Replace the shape of a plot. Throws an exception, and changes nothing, if the new shape intersects itself
+ * 
+ * @param number 
+ * @param vertices 
+ */
+void MapEditor::reshape(int number, const vector<Point2D<int, float>>& vertices)
+{
+    const Plot& plot = getPlot(number);
+    Polygon<int, float> shape(vertices);
+    replace(indexOf(number), makePlot(plot.getType(), plot, move(shape), builtAreaOf(plot), cropTypeOf(plot)));
+}
+
+/**
+ * @brief Move the shape of a plot
+ * 
+ * @param number 
+ * @param dx 
+ * @param dy 
+ */
+void MapEditor::translate(int number, int dx, float dy)
+{
+    const Plot& plot = getPlot(number);
+    Polygon<int, float> shape(*plot.getShape());
+    shape.translate(dx, dy);
+    replace(indexOf(number), makePlot(plot.getType(), plot, move(shape), builtAreaOf(plot), cropTypeOf(plot)));
+}
+
+/**
+ * @brief Change the built area of an urban zone. Throws an exception if the plot is not an urban zone
+ * 
+ * @param number 
+ * @param builtArea in square meters 
+ */
+void MapEditor::setBuiltArea(int number, float builtArea)
+{
+    const Plot& plot = getPlot(number);
+    if (plot.getType() != PlotType::URBAN_ZONE)
+    {
+        throw runtime_error("Plot " + to_string(number) + " is not an urban zone");
+    }
+    replace(indexOf(number), makePlot(PlotType::URBAN_ZONE, plot, Polygon<int, float>(*plot.getShape()), builtArea, ""));
+}
+
+/**
+ * @brief Change the type of a plot, e.g. a zone to be urbanized becoming an urban zone. The number, owner, shape and percentage of buildable area are kept
+ * 
+ * @param number 
+ * @param type 
+ * @param builtArea for an urban zone, kept as is even if 0
+ * @param cropType for an agricultural zone 
+ */
+void MapEditor::reclassify(int number, PlotType type, float builtArea, const string& cropType)
+{
+    const Plot& plot = getPlot(number);
+    replace(indexOf(number), makePlot(type, plot, Polygon<int, float>(*plot.getShape()), builtArea, cropType));
+}
+
+/**
+ * @brief Publish the edits as a new snapshot, then let the next editor in. Throws an exception if they were already committed
+ * 
+ * @return uint64_t version of the new snapshot 
+ */
+uint64_t MapEditor::commit()
+{
+    if (this->committed)
+    {
+        throw logic_error("The edits have already been committed");
+    }
+    vector<shared_ptr<const Plot>> owners = this->base->owners;
+    for (auto& change : this->changes)
+    {
+        owners[change.first] = move(change.second);
+    }
+    MapSnapshot* snapshot = new MapSnapshot(this->base->version + 1, move(owners));
+    this->map->publish(snapshot);
+    this->committed = true;
+    this->changes.clear();
+    this->lock.unlock();
+    return snapshot->version;
+}
+
+/**
+ * @brief Check if the edits were published
+ * 
+ * @return bool 
+ */
+bool MapEditor::isCommitted() const
+{
+    return this->committed;
+}
+
+/**
+ * @brief Construct a new empty ConcurrentMap::ConcurrentMap object
+ * 
+ */
+ConcurrentMap::ConcurrentMap() : current(nullptr), epoch(1)
+{
+    for (auto& reader : this->readers)
+    {
+        reader.used = false;
+        reader.epoch = 0;
+    }
+    this->current = new MapSnapshot(0, vector<shared_ptr<const Plot>>());
+}
+
+/**
+ * @brief Construct a new ConcurrentMap::ConcurrentMap object from a file in the text format
+ * 
+ * @param filename 
+ */
+ConcurrentMap::ConcurrentMap(const string& filename) : ConcurrentMap()
+{
+    load(filename);
+}
+
+/**
+ * @brief Destroy the ConcurrentMap::ConcurrentMap object and all its snapshots. No reader may be left
+ * 
+ */
+ConcurrentMap::~ConcurrentMap()
+{
+    delete this->current.load();
+    for (auto& snapshot : this->retired)
+    {
+        delete snapshot.second;
+    }
+}
+
+/**
+ * @brief Replace the plots of the map by the plots of a file in the text format, as a new snapshot
+ * 
+ * @param filename 
+ */
+void ConcurrentMap::load(const string& filename)
+{
+    lock_guard<mutex> guard(this->writer);
+    vector<Plot*> loaded = loadPlots(filename);
+    vector<shared_ptr<const Plot>> owners;
+    owners.reserve(loaded.size());
+    for (auto plot : loaded)
+    {
+        plot->setShape(unique_ptr<Polygon<int, float>>(plot->getShape())); // the plot owns its shape, and deletes it with itself
+        owners.push_back(shared_ptr<const Plot>(plot));
+    }
+    publish(new MapSnapshot(this->current.load()->version + 1, move(owners)));
+}
+
+/**
+ * @brief Get the current snapshot, valid as long as the guard lives. Never blocks
+ * 
+ * @return MapReadGuard 
+ */
+MapReadGuard ConcurrentMap::read() const
+{
+    return MapReadGuard(this);
+}
+
+/**
+ * @brief Start editing the map, once the previous editor is done
+ * 
+ * @return MapEditor 
+ */
+MapEditor ConcurrentMap::edit()
+{
+    return MapEditor(this);
+}
+
+/**
+ * @brief Make a snapshot the current one, retire the previous one with the current epoch, and move on to the next epoch. Called with the writer lock held
+ * 
+ * @param snapshot 
+ */
+void ConcurrentMap::publish(const MapSnapshot* snapshot)
+{
+    const MapSnapshot* previous = this->current.exchange(snapshot);
+    this->retired.push_back(make_pair(this->epoch.fetch_add(1), previous));
+    reclaim();
+}
+
+/**
+ * @brief Delete the retired snapshots that no reader can use anymore: those retired before the oldest epoch of the readers. Called with the writer lock held
+ * 
+ */
+void ConcurrentMap::reclaim()
+{
+    uint64_t oldest = numeric_limits<uint64_t>::max();
+    for (const auto& reader : this->readers)
+    {
+        uint64_t e = reader.epoch.load();
+        if (e != 0 && e < oldest)
+        {
+            oldest = e;
+        }
+    }
+    size_t kept = 0;
+    for (auto& snapshot : this->retired)
+    {
+        if (snapshot.first < oldest)
+        {
+            delete snapshot.second;
+        }
+        else
+        {
+            this->retired[kept++] = snapshot;
+        }
+    }
+    this->retired.resize(kept);
+}
+
+/**
+ * @brief Get the number of replaced snapshots still kept for their readers, after deleting those that have none
+ * 
+ * @return size_t 
+ */
+size_t ConcurrentMap::getRetiredCount()
+{
+    lock_guard<mutex> guard(this->writer);
+    reclaim();
+    return this->retired.size();
+}
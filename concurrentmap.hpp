@@ -0,0 +1,145 @@
+/**
+ * @file concurrentmap.hpp
+ * @author Bastien, Victor, AlexisR 
+ * @brief Header file for the ConcurrentMap class, a map read through immutable snapshots while it is edited
+ * @version 0.1
+ * @date 2024-01-16
+ * 
+ * @copyright Copyright (c) 2024
+ * 
+ */
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include "map.hpp"
+#include "rtree.hpp"
+
+#ifndef CONCURRENTMAP_HPP
+#define CONCURRENTMAP_HPP
+
+using namespace std;
+
+class ConcurrentMap;
+
+/**
+ * @brief The MapSnapshot class is one version of a ConcurrentMap. It is never modified once published, so any number of threads can query it without locking.
+ * The plots own their shapes; a plot that is not changed by an edit is shared with the next snapshot instead of being copied
+ * 
+ */
+class MapSnapshot
+{
+    private:
+        uint64_t version;
+        vector<shared_ptr<const Plot>> owners; // keep the plots alive as long as a snapshot uses them
+        vector<const Plot*> plots;
+        RTree<const Plot*> index;
+        unordered_map<int, size_t> numbers; // plot number -> position of its first plot
+        MapSnapshot(uint64_t version, vector<shared_ptr<const Plot>> owners);
+        friend class ConcurrentMap;
+        friend class MapEditor;
+    public:
+        MapSnapshot(const MapSnapshot& s) = delete;
+        MapSnapshot& operator=(const MapSnapshot& s) = delete;
+        uint64_t getVersion() const;
+        size_t getPlotCount() const;
+        const vector<const Plot*>& getPlots() const;
+        const Plot* findPlot(int number) const;
+        const Plot* findPlotAt(double x, double y) const;
+        vector<const Plot*> findPlotsIn(const BoundingBox& box) const;
+        MapAggregates aggregate(unsigned threadCount = 0) const;
+};
+
+/**
+ * @brief The MapReadGuard class gives access to the current snapshot of a ConcurrentMap. The snapshot stays valid, and unchanged, until the guard is destroyed, whatever the writer publishes meanwhile.
+ * Taking a guard never blocks: it only writes the epoch of the reader in a slot of the map
+ * 
+ */
+class MapReadGuard
+{
+    private:
+        const ConcurrentMap* map;
+        size_t slot;
+        const MapSnapshot* snapshot;
+    public:
+        MapReadGuard(const ConcurrentMap* map);
+        MapReadGuard(const MapReadGuard& g) = delete;
+        MapReadGuard& operator=(const MapReadGuard& g) = delete;
+        MapReadGuard(MapReadGuard&& g);
+        ~MapReadGuard();
+        const MapSnapshot& operator*() const { return *this->snapshot; }
+        const MapSnapshot* operator->() const { return this->snapshot; }
+};
+
+/**
+ * @brief The MapEditor class collects edits of the plots of a ConcurrentMap and publishes them together, as one new snapshot, on commit().
+ * There is one editor at a time: creating one waits for the previous one to be committed or destroyed. Readers are never blocked. An editor destroyed without commit() discards its edits
+ * 
+ */
+class MapEditor
+{
+    private:
+        ConcurrentMap* map;
+        unique_lock<mutex> lock;
+        const MapSnapshot* base;
+        unordered_map<size_t, shared_ptr<const Plot>> changes; // position -> new version of the plot
+        bool committed;
+        size_t indexOf(int number) const;
+        void replace(size_t i, Plot* plot);
+    public:
+        MapEditor(ConcurrentMap* map);
+        MapEditor(const MapEditor& e) = delete;
+        MapEditor& operator=(const MapEditor& e) = delete;
+        MapEditor(MapEditor&& e) = default;
+        const Plot& getPlot(int number) const;
+        void reshape(int number, const vector<Point2D<int, float>>& vertices);
+        void translate(int number, int dx, float dy);
+        void setBuiltArea(int number, float builtArea);
+        void reclassify(int number, PlotType type, float builtArea = 0, const string& cropType = "");
+        uint64_t commit();
+        bool isCommitted() const;
+};
+
+/**
+ * @brief The ConcurrentMap class is a map that many threads can query while one thread edits it. Readers work on an immutable snapshot (see read()); the writer builds the next snapshot aside (see edit()) and publishes it with a single atomic store.
+ * A replaced snapshot is retired with the current epoch and deleted by the writer once every reader has moved to a later epoch, as in RCU
+ * 
+ */
+class ConcurrentMap
+{
+    private:
+        static const size_t MAX_READERS = 128;
+
+        /**
+         * @brief Epoch of a reader, 0 when the slot is free. Each slot has its own cache line, so that readers do not slow each other down
+         * 
+         */
+        struct alignas(64) ReaderSlot
+        {
+            atomic<bool> used;
+            atomic<uint64_t> epoch;
+        };
+        mutable ReaderSlot readers[MAX_READERS];
+        atomic<const MapSnapshot*> current;
+        atomic<uint64_t> epoch;
+        mutex writer;
+        vector<pair<uint64_t, const MapSnapshot*>> retired; // snapshots replaced at an epoch, that readers may still use. Guarded by writer
+        void publish(const MapSnapshot* snapshot);
+        void reclaim();
+        friend class MapReadGuard;
+        friend class MapEditor;
+    public:
+        ConcurrentMap();
+        ConcurrentMap(const string& filename);
+        ConcurrentMap(const ConcurrentMap& m) = delete;
+        ConcurrentMap& operator=(const ConcurrentMap& m) = delete;
+        ~ConcurrentMap();
+        void load(const string& filename);
+        MapReadGuard read() const;
+        MapEditor edit();
+        size_t getRetiredCount();
+};
+
+#endif // CONCURRENTMAP_HPP
@@ -0,0 +1,208 @@
+/**
+ * @file geometrybuffer.hpp
+ * @author Bastien, Victor, AlexisR 
+ * @brief Header file for the GeometryBuffer class
+ * @version 0.1
+ * @date 2024-01-16
+ * 
+ * @copyright Copyright (c) 2024
+ * 
+ */
+
+#include <vector>
+#include "polygon.hpp"
+#include "geometrykernels.hpp"
+
+#ifndef GEOMETRYBUFFER_HPP
+#define GEOMETRYBUFFER_HPP
+
+using namespace std;
+
+/**
+ * @brief The GeometryBuffer class stores many polygons as a structure of arrays: all the x coordinates in one contiguous array, all the y coordinates in another, and the offset of each polygon. This is the layout expected by the vectorized kernels of geometrykernels.hpp
+ * 
+ */
+template <typename T, typename U>
+class GeometryBuffer
+{
+    private:
+        vector<T> x;
+        vector<U> y;
+        vector<size_t> offsets; // polygon i uses the vertices [offsets[i], offsets[i+1])
+    public:
+        GeometryBuffer();
+        void reserve(size_t polygonCount, size_t vertexCount);
+        void clear();
+        size_t addPolygon(const Polygon<T, U>& polygon);
+        size_t getPolygonCount() const;
+        size_t getVertexCount(size_t i) const;
+        const T* getX(size_t i) const;
+        const U* getY(size_t i) const;
+        double getSignedArea(size_t i) const;
+        double getPerimeter(size_t i) const;
+        void computeSignedAreas(vector<double>& areas) const;
+};
+
+/**
+ * @brief Construct a new empty GeometryBuffer<T, U>::GeometryBuffer object
+ * 
+ * @tparam T 
+ * @tparam U 
+ */
+template <typename T, typename U>
+GeometryBuffer<T, U>::GeometryBuffer()
+{
+    this->offsets.push_back(0);
+}
+
+/**
+ * @brief Reserve the storage for a bulk import, to avoid reallocations
+ * 
+ * @tparam T 
+ * @tparam U 
+ * @param polygonCount 
+ * @param vertexCount total number of vertices over all polygons
+ */
+template <typename T, typename U>
+void GeometryBuffer<T, U>::reserve(size_t polygonCount, size_t vertexCount)
+{
+    this->x.reserve(vertexCount);
+    this->y.reserve(vertexCount);
+    this->offsets.reserve(polygonCount + 1);
+}
+
+/**
+ * @brief Remove all the polygons
+ * 
+ * @tparam T 
+ * @tparam U 
+ */
+template <typename T, typename U>
+void GeometryBuffer<T, U>::clear()
+{
+    this->x.clear();
+    this->y.clear();
+    this->offsets.assign(1, 0);
+}
+
+/**
+ * @brief Copy the vertices of a polygon at the end of the buffer
+ * 
+ * @tparam T 
+ * @tparam U 
+ * @param polygon 
+ * @return size_t index of the polygon in the buffer
+ */
+template <typename T, typename U>
+size_t GeometryBuffer<T, U>::addPolygon(const Polygon<T, U>& polygon)
+{
+    for (const auto& vertex : polygon.getVertexView())
+    {
+        this->x.push_back(vertex.getX());
+        this->y.push_back(vertex.getY());
+    }
+    this->offsets.push_back(this->x.size());
+    return this->offsets.size() - 2;
+}
+
+/**
+ * @brief Get the number of polygons in the buffer
+ * 
+ * @tparam T 
+ * @tparam U 
+ * @return size_t 
+ */
+template <typename T, typename U>
+size_t GeometryBuffer<T, U>::getPolygonCount() const
+{
+    return this->offsets.size() - 1;
+}
+
+/**
+ * @brief Get the number of vertices of polygon i
+ * 
+ * @tparam T 
+ * @tparam U 
+ * @param i 
+ * @return size_t 
+ */
+template <typename T, typename U>
+size_t GeometryBuffer<T, U>::getVertexCount(size_t i) const
+{
+    return this->offsets[i+1] - this->offsets[i];
+}
+
+/**
+ * @brief Get the x coordinates of polygon i
+ * 
+ * @tparam T 
+ * @tparam U 
+ * @param i 
+ * @return const T* 
+ */
+template <typename T, typename U>
+const T* GeometryBuffer<T, U>::getX(size_t i) const
+{
+    return this->x.data() + this->offsets[i];
+}
+
+/**
+ * @brief Get the y coordinates of polygon i
+ * 
+ * @tparam T 
+ * @tparam U 
+ * @param i 
+ * @return const U* 
+ */
+template <typename T, typename U>
+const U* GeometryBuffer<T, U>::getY(size_t i) const
+{
+    return this->y.data() + this->offsets[i];
+}
+
+/**
+ * @brief Get the signed area of polygon i
+ * 
+ * @tparam T 
+ * @tparam U 
+ * @param i 
+ * @return double 
+ */
+template <typename T, typename U>
+double GeometryBuffer<T, U>::getSignedArea(size_t i) const
+{
+    return shoelaceTwiceArea(getX(i), getY(i), getVertexCount(i)) / 2;
+}
+
+/**
+ * @brief Get the perimeter of polygon i
+ * 
+ * @tparam T 
+ * @tparam U 
+ * @param i 
+ * @return double 
+ */
+template <typename T, typename U>
+double GeometryBuffer<T, U>::getPerimeter(size_t i) const
+{
+    return perimeter(getX(i), getY(i), getVertexCount(i));
+}
+
+/**
+ * @brief Compute the signed area of every polygon of the buffer, in one pass over the coordinate arrays
+ * 
+ * @tparam T 
+ * @tparam U 
+ * @param areas resized to getPolygonCount()
+ */
+template <typename T, typename U>
+void GeometryBuffer<T, U>::computeSignedAreas(vector<double>& areas) const
+{
+    areas.resize(getPolygonCount());
+    for (size_t i = 0; i < areas.size(); i++)
+    {
+        areas[i] = getSignedArea(i);
+    }
+}
+
+#endif // GEOMETRYBUFFER_HPP
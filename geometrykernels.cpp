@@ -0,0 +1,210 @@
+/**
+ * @file geometrykernels.cpp
+ * @author Bastien, Victor, AlexisR 
+ * @brief Implementation file for the vectorized area and perimeter kernels
+ * @version 0.1
+ * @date 2024-01-16
+ * 
+ * @copyright Copyright (c) 2024
+ * 
+ */
+
+#include "geometrykernels.hpp"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define GEOMETRY_KERNELS_X86
+#include <immintrin.h>
+#endif
+
+using namespace std;
+
+/**
+ * @brief Set of kernels sharing the same instruction set
+ * 
+ */
+struct GeometryKernels
+{
+    const char* name;
+    double (*twiceArea)(const int* x, const float* y, size_t n);
+    double (*perimeter)(const int* x, const float* y, size_t n);
+};
+
+/**
+ * @brief Closing edge (last vertex, first vertex) of the shoelace sum, shared by all kernels
+ * 
+ */
+static double closingTerm(const int* x, const float* y, size_t n)
+{
+    return static_cast<double>(x[n-1]) * y[0] - static_cast<double>(x[0]) * y[n-1];
+}
+
+static double scalarTwiceArea(const int* x, const float* y, size_t n)
+{
+    return shoelaceTwiceArea<int, float>(x, y, n);
+}
+
+static double scalarPerimeter(const int* x, const float* y, size_t n)
+{
+    return perimeter<int, float>(x, y, n);
+}
+
+#ifdef GEOMETRY_KERNELS_X86
+
+/**
+ * @brief SSE2 kernel, 2 edges per step
+ * 
+ */
+__attribute__((target("sse2")))
+static double sse2TwiceArea(const int* x, const float* y, size_t n)
+{
+    if (n < 2)
+    {
+        return 0;
+    }
+    __m128d acc = _mm_setzero_pd();
+    size_t i = 0;
+    for (; i + 2 < n; i += 2) // edges (i, i+1) and (i+1, i+2)
+    {
+        __m128d xi = _mm_cvtepi32_pd(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(x + i)));
+        __m128d xn = _mm_cvtepi32_pd(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(x + i + 1)));
+        __m128d yi = _mm_cvtps_pd(_mm_castsi128_ps(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(y + i))));
+        __m128d yn = _mm_cvtps_pd(_mm_castsi128_ps(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(y + i + 1))));
+        acc = _mm_add_pd(acc, _mm_sub_pd(_mm_mul_pd(xi, yn), _mm_mul_pd(xn, yi)));
+    }
+    double lanes[2];
+    _mm_storeu_pd(lanes, acc);
+    double sum = lanes[0] + lanes[1];
+    for (; i + 1 < n; i++)
+    {
+        sum += static_cast<double>(x[i]) * y[i+1] - static_cast<double>(x[i+1]) * y[i];
+    }
+    return sum + closingTerm(x, y, n);
+}
+
+__attribute__((target("sse2")))
+static double sse2Perimeter(const int* x, const float* y, size_t n)
+{
+    if (n < 2)
+    {
+        return 0;
+    }
+    __m128d acc = _mm_setzero_pd();
+    size_t i = 0;
+    for (; i + 2 < n; i += 2)
+    {
+        __m128d dx = _mm_sub_pd(_mm_cvtepi32_pd(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(x + i + 1))), _mm_cvtepi32_pd(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(x + i))));
+        __m128d dy = _mm_sub_pd(_mm_cvtps_pd(_mm_castsi128_ps(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(y + i + 1)))), _mm_cvtps_pd(_mm_castsi128_ps(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(y + i)))));
+        acc = _mm_add_pd(acc, _mm_sqrt_pd(_mm_add_pd(_mm_mul_pd(dx, dx), _mm_mul_pd(dy, dy))));
+    }
+    double lanes[2];
+    _mm_storeu_pd(lanes, acc);
+    double sum = lanes[0] + lanes[1];
+    for (; i + 1 < n; i++)
+    {
+        sum += hypot(static_cast<double>(x[i+1]) - x[i], static_cast<double>(y[i+1]) - y[i]);
+    }
+    return sum + hypot(static_cast<double>(x[0]) - x[n-1], static_cast<double>(y[0]) - y[n-1]);
+}
+
+/**
+ * @brief AVX2 kernel, 8 edges per step on two accumulators
+ * 
+ */
+__attribute__((target("avx2")))
+static double avx2TwiceArea(const int* x, const float* y, size_t n)
+{
+    if (n < 2)
+    {
+        return 0;
+    }
+    __m256d acc0 = _mm256_setzero_pd();
+    __m256d acc1 = _mm256_setzero_pd();
+    size_t i = 0;
+    for (; i + 8 < n; i += 8) // edges (i, i+1) ... (i+7, i+8)
+    {
+        __m256d xi0 = _mm256_cvtepi32_pd(_mm_loadu_si128(reinterpret_cast<const __m128i*>(x + i)));
+        __m256d xn0 = _mm256_cvtepi32_pd(_mm_loadu_si128(reinterpret_cast<const __m128i*>(x + i + 1)));
+        __m256d yi0 = _mm256_cvtps_pd(_mm_loadu_ps(y + i));
+        __m256d yn0 = _mm256_cvtps_pd(_mm_loadu_ps(y + i + 1));
+        __m256d xi1 = _mm256_cvtepi32_pd(_mm_loadu_si128(reinterpret_cast<const __m128i*>(x + i + 4)));
+        __m256d xn1 = _mm256_cvtepi32_pd(_mm_loadu_si128(reinterpret_cast<const __m128i*>(x + i + 5)));
+        __m256d yi1 = _mm256_cvtps_pd(_mm_loadu_ps(y + i + 4));
+        __m256d yn1 = _mm256_cvtps_pd(_mm_loadu_ps(y + i + 5));
+        acc0 = _mm256_add_pd(acc0, _mm256_sub_pd(_mm256_mul_pd(xi0, yn0), _mm256_mul_pd(xn0, yi0)));
+        acc1 = _mm256_add_pd(acc1, _mm256_sub_pd(_mm256_mul_pd(xi1, yn1), _mm256_mul_pd(xn1, yi1)));
+    }
+    double lanes[4];
+    _mm256_storeu_pd(lanes, _mm256_add_pd(acc0, acc1));
+    double sum = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+    for (; i + 1 < n; i++)
+    {
+        sum += static_cast<double>(x[i]) * y[i+1] - static_cast<double>(x[i+1]) * y[i];
+    }
+    return sum + closingTerm(x, y, n);
+}
+
+__attribute__((target("avx2")))
+static double avx2Perimeter(const int* x, const float* y, size_t n)
+{
+    if (n < 2)
+    {
+        return 0;
+    }
+    __m256d acc = _mm256_setzero_pd();
+    size_t i = 0;
+    for (; i + 4 < n; i += 4)
+    {
+        __m256d dx = _mm256_sub_pd(_mm256_cvtepi32_pd(_mm_loadu_si128(reinterpret_cast<const __m128i*>(x + i + 1))), _mm256_cvtepi32_pd(_mm_loadu_si128(reinterpret_cast<const __m128i*>(x + i))));
+        __m256d dy = _mm256_sub_pd(_mm256_cvtps_pd(_mm_loadu_ps(y + i + 1)), _mm256_cvtps_pd(_mm_loadu_ps(y + i)));
+        acc = _mm256_add_pd(acc, _mm256_sqrt_pd(_mm256_add_pd(_mm256_mul_pd(dx, dx), _mm256_mul_pd(dy, dy))));
+    }
+    double lanes[4];
+    _mm256_storeu_pd(lanes, acc);
+    double sum = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+    for (; i + 1 < n; i++)
+    {
+        sum += hypot(static_cast<double>(x[i+1]) - x[i], static_cast<double>(y[i+1]) - y[i]);
+    }
+    return sum + hypot(static_cast<double>(x[0]) - x[n-1], static_cast<double>(y[0]) - y[n-1]);
+}
+
+#endif // GEOMETRY_KERNELS_X86
+
+/**
+ * @brief Pick the best kernels supported by the CPU. Done once, on first use
+ * 
+ * @return const GeometryKernels& 
+ */
+static const GeometryKernels& selectKernels()
+{
+    static const GeometryKernels kernels = []() {
+#ifdef GEOMETRY_KERNELS_X86
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2"))
+        {
+            return GeometryKernels{"avx2", avx2TwiceArea, avx2Perimeter};
+        }
+        if (__builtin_cpu_supports("sse2"))
+        {
+            return GeometryKernels{"sse2", sse2TwiceArea, sse2Perimeter};
+        }
+#endif
+        return GeometryKernels{"scalar", scalarTwiceArea, scalarPerimeter};
+    }();
+    return kernels;
+}
+
+double shoelaceTwiceArea(const int* x, const float* y, size_t n)
+{
+    return selectKernels().twiceArea(x, y, n);
+}
+
+double perimeter(const int* x, const float* y, size_t n)
+{
+    return selectKernels().perimeter(x, y, n);
+}
+
+const char* getGeometryKernelName()
+{
+    return selectKernels().name;
+}
@@ -0,0 +1,97 @@
+/**
+ * @file geometrykernels.hpp
+ * @author Bastien, Victor, AlexisR 
+ * @brief Header file for the vectorized area and perimeter kernels working on separate x[] and y[] arrays
+ * @version 0.1
+ * @date 2024-01-16
+ * 
+ * @copyright Copyright (c) 2024
+ * 
+ */
+
+#include <cmath>
+#include <cstddef>
+
+#ifndef GEOMETRYKERNELS_HPP
+#define GEOMETRYKERNELS_HPP
+
+using namespace std;
+
+/**
+ * @brief Twice the signed area of the polygon (x[i], y[i]), using the shoelace formula. Generic scalar version, used for coordinate types without a vectorized kernel
+ * 
+ * @tparam T 
+ * @tparam U 
+ * @param x 
+ * @param y 
+ * @param n number of vertices
+ * @return double 
+ */
+template <typename T, typename U>
+double shoelaceTwiceArea(const T* x, const U* y, size_t n)
+{
+    double sum = 0;
+    for (size_t i = 0; i + 1 < n; i++)
+    {
+        sum += static_cast<double>(x[i]) * y[i+1] - static_cast<double>(x[i+1]) * y[i];
+    }
+    if (n > 0)
+    {
+        sum += static_cast<double>(x[n-1]) * y[0] - static_cast<double>(x[0]) * y[n-1];
+    }
+    return sum;
+}
+
+/**
+ * @brief Perimeter of the polygon (x[i], y[i]). Generic scalar version, used for coordinate types without a vectorized kernel
+ * 
+ * @tparam T 
+ * @tparam U 
+ * @param x 
+ * @param y 
+ * @param n number of vertices
+ * @return double 
+ */
+template <typename T, typename U>
+double perimeter(const T* x, const U* y, size_t n)
+{
+    double sum = 0;
+    for (size_t i = 0; i + 1 < n; i++)
+    {
+        sum += hypot(static_cast<double>(x[i+1]) - x[i], static_cast<double>(y[i+1]) - y[i]);
+    }
+    if (n > 1)
+    {
+        sum += hypot(static_cast<double>(x[0]) - x[n-1], static_cast<double>(y[0]) - y[n-1]);
+    }
+    return sum;
+}
+
+/**
+ * @brief Twice the signed area for the coordinates used by the plots. The AVX2, SSE2 or scalar kernel is picked at runtime from what the CPU supports
+ * 
+ * @param x 
+ * @param y 
+ * @param n number of vertices
+ * @return double 
+ */
+double shoelaceTwiceArea(const int* x, const float* y, size_t n);
+
+/**
+ * @brief Perimeter for the coordinates used by the plots. The AVX2, SSE2 or scalar kernel is picked at runtime from what the CPU supports
+ * 
+ * @param x 
+ * @param y 
+ * @param n number of vertices
+ * @return double 
+ */
+double perimeter(const int* x, const float* y, size_t n);
+
+/**
+ * @brief Name of the kernel picked at runtime ("avx2", "sse2" or "scalar")
+ * 
+ * @return const char* 
+ */
+const char* getGeometryKernelName();
+
+#endif // GEOMETRYKERNELS_HPP
@@ -0,0 +1,572 @@
+/**
+ * @file intersection.hpp
+ * @author Bastien, Victor, AlexisR 
+ * @brief Header file for the segment intersection tests and the Shamos-Hoey sweep line used to check that a polygon is simple
+ * @version 0.1
+ * @date 2024-01-16
+ * 
+ * @copyright Copyright (c) 2024
+ * 
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <set>
+#include <vector>
+#include "point2d.hpp"
+
+#ifndef INTERSECTION_HPP
+#define INTERSECTION_HPP
+
+using namespace std;
+
+/**
+ * @brief Sign of the cross product (b - a) x (c - a): 1 if c is on the left of the line (a, b), -1 if it is on the right, 0 if the three points are aligned
+ * 
+ * @tparam T 
+ * @tparam U 
+ * @param a 
+ * @param b 
+ * @param c 
+ * @return int 
+ */
+template <typename T, typename U>
+int orientation(const Point2D<T, U>& a, const Point2D<T, U>& b, const Point2D<T, U>& c)
+{
+    long double cross = (static_cast<long double>(b.getX()) - a.getX()) * (static_cast<long double>(c.getY()) - a.getY())
+        - (static_cast<long double>(b.getY()) - a.getY()) * (static_cast<long double>(c.getX()) - a.getX());
+    return (cross > 0) - (cross < 0);
+}
+
+/**
+ * @brief Check if c, aligned with a and b, lies between them
+ * 
+ */
+template <typename T, typename U>
+bool isOnSegment(const Point2D<T, U>& a, const Point2D<T, U>& b, const Point2D<T, U>& c)
+{
+    return min(a.getX(), b.getX()) <= c.getX() && c.getX() <= max(a.getX(), b.getX())
+        && min(a.getY(), b.getY()) <= c.getY() && c.getY() <= max(a.getY(), b.getY());
+}
+
+/**
+ * @brief Check if the segments [a, b] and [c, d] have at least one point in common
+ * 
+ * @tparam T 
+ * @tparam U 
+ * @return bool 
+ */
+template <typename T, typename U>
+bool segmentsIntersect(const Point2D<T, U>& a, const Point2D<T, U>& b, const Point2D<T, U>& c, const Point2D<T, U>& d)
+{
+    int o1 = orientation(a, b, c);
+    int o2 = orientation(a, b, d);
+    int o3 = orientation(c, d, a);
+    int o4 = orientation(c, d, b);
+    if (o1 != o2 && o3 != o4)
+    {
+        return true;
+    }
+    return (o1 == 0 && isOnSegment(a, b, c)) || (o2 == 0 && isOnSegment(a, b, d))
+        || (o3 == 0 && isOnSegment(c, d, a)) || (o4 == 0 && isOnSegment(c, d, b));
+}
+
+/**
+ * @brief Check if two edges of a polygon intersect. Edge i goes from vertex i to vertex i+1 (the last one goes back to vertex 0).
+ * Consecutive edges always share a vertex, so they only count as intersecting if they overlap, i.e. if the polygon turns back on itself, or if one of them is empty (repeated vertex)
+ * 
+ * @tparam T 
+ * @tparam U 
+ * @param v vertices of the polygon
+ * @param n number of vertices
+ * @param i 
+ * @param j 
+ * @return bool 
+ */
+template <typename T, typename U>
+bool edgesIntersect(const Point2D<T, U>* v, size_t n, size_t i, size_t j)
+{
+    if (i == j)
+    {
+        return false;
+    }
+    size_t iNext = (i + 1) % n;
+    size_t jNext = (j + 1) % n;
+    if (iNext == j || jNext == i)
+    {
+        // shared vertex s, other ends p and q: they overlap if q is aligned with (s, p) on the same side of s
+        const Point2D<T, U>& s = iNext == j ? v[j] : v[i];
+        const Point2D<T, U>& p = iNext == j ? v[i] : v[iNext];
+        const Point2D<T, U>& q = iNext == j ? v[jNext] : v[j];
+        if (iNext == j && jNext == i) // polygon with 2 vertices, both edges are the same segment
+        {
+            return true;
+        }
+        bool pIsS = p.getX() == s.getX() && p.getY() == s.getY();
+        bool qIsS = q.getX() == s.getX() && q.getY() == s.getY();
+        if (pIsS || qIsS)
+        {
+            return true;
+        }
+        long double dot = (static_cast<long double>(p.getX()) - s.getX()) * (static_cast<long double>(q.getX()) - s.getX())
+            + (static_cast<long double>(p.getY()) - s.getY()) * (static_cast<long double>(q.getY()) - s.getY());
+        return orientation(s, p, q) == 0 && dot > 0;
+    }
+    return segmentsIntersect(v[i], v[iNext], v[j], v[jNext]);
+}
+
+/**
+ * @brief Lexicographic order on the points, x first then y
+ * 
+ */
+template <typename T, typename U>
+bool isBefore(const Point2D<T, U>& a, const Point2D<T, U>& b)
+{
+    return a.getX() < b.getX() || (a.getX() == b.getX() && a.getY() < b.getY());
+}
+
+/**
+ * @brief Look for two intersecting edges with the Shamos-Hoey sweep line, in O(n log n).
+ * A vertical line sweeps the plane from left to right. The edges crossing it are kept sorted from bottom to top, and an edge is only tested against its neighbours in that order when it is inserted, and its two neighbours against each other when it is removed. The first intersection, if there is one, is always found this way
+ * 
+ * @tparam T 
+ * @tparam U 
+ * @param v vertices of the polygon
+ * @param n number of vertices
+ * @param first set to the index of one of the intersecting edges
+ * @param second set to the index of the other one
+ * @return bool true if an intersection was found
+ */
+template <typename T, typename U>
+bool findSelfIntersection(const Point2D<T, U>* v, size_t n, size_t& first, size_t& second)
+{
+    if (n < 3)
+    {
+        return false;
+    }
+    for (size_t i = 0; i < n; i++)
+    {
+        const Point2D<T, U>& a = v[i];
+        const Point2D<T, U>& b = v[(i + 1) % n];
+        if (a.getX() == b.getX() && a.getY() == b.getY())
+        {
+            // repeated vertex: edge i is empty, see edgesIntersect()
+            first = min(i, (i + 1) % n);
+            second = max(i, (i + 1) % n);
+            return true;
+        }
+    }
+    auto leftEnd = [&](size_t e) -> const Point2D<T, U>& { return isBefore(v[(e + 1) % n], v[e]) ? v[(e + 1) % n] : v[e]; };
+    auto rightEnd = [&](size_t e) -> const Point2D<T, U>& { return isBefore(v[(e + 1) % n], v[e]) ? v[e] : v[(e + 1) % n]; };
+
+    // s is inserted after t (its left end comes later): is s below t at the x of its left end?
+    auto isBelow = [&](size_t s, size_t t) {
+        int o = orientation(leftEnd(t), rightEnd(t), leftEnd(s));
+        if (o == 0)
+        {
+            o = orientation(leftEnd(t), rightEnd(t), rightEnd(s));
+        }
+        return o != 0 ? o < 0 : s < t;
+    };
+    auto compare = [&](size_t a, size_t b) {
+        if (a == b)
+        {
+            return false;
+        }
+        const Point2D<T, U>& la = leftEnd(a);
+        const Point2D<T, U>& lb = leftEnd(b);
+        bool aIsNewer = isBefore(lb, la) || (!isBefore(la, lb) && a > b);
+        return aIsNewer ? isBelow(a, b) : !isBelow(b, a);
+    };
+
+    // events: 2 * e for the left end of edge e, 2 * e + 1 for its right end
+    vector<size_t> events(2 * n);
+    for (size_t i = 0; i < 2 * n; i++)
+    {
+        events[i] = i;
+    }
+    sort(events.begin(), events.end(), [&](size_t a, size_t b) {
+        const Point2D<T, U>& pa = a % 2 == 0 ? leftEnd(a / 2) : rightEnd(a / 2);
+        const Point2D<T, U>& pb = b % 2 == 0 ? leftEnd(b / 2) : rightEnd(b / 2);
+        if (isBefore(pa, pb) || isBefore(pb, pa))
+        {
+            return isBefore(pa, pb);
+        }
+        return a % 2 < b % 2 || (a % 2 == b % 2 && a < b); // at the same point, insert before removing
+    });
+
+    set<size_t, decltype(compare)> status(compare);
+    vector<typename set<size_t, decltype(compare)>::iterator> positions(n);
+    auto check = [&](size_t a, size_t b) {
+        if (edgesIntersect(v, n, a, b))
+        {
+            first = min(a, b);
+            second = max(a, b);
+            return true;
+        }
+        return false;
+    };
+    for (size_t event : events)
+    {
+        size_t e = event / 2;
+        if (event % 2 == 0)
+        {
+            auto it = status.insert(e).first;
+            positions[e] = it;
+            if (it != status.begin() && check(*prev(it), e))
+            {
+                return true;
+            }
+            if (next(it) != status.end() && check(e, *next(it)))
+            {
+                return true;
+            }
+        }
+        else
+        {
+            auto it = positions[e];
+            if (it != status.begin() && next(it) != status.end() && check(*prev(it), *next(it)))
+            {
+                return true;
+            }
+            status.erase(it);
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Locate the point (x, y) with respect to a polygon
+ * 
+ * @tparam T 
+ * @tparam U 
+ * @param v vertices of the polygon
+ * @param n number of vertices
+ * @param x 
+ * @param y 
+ * @return int 1 if the point is inside, 0 if it is on an edge, -1 if it is outside
+ */
+template <typename T, typename U>
+int locatePoint(const Point2D<T, U>* v, size_t n, double x, double y)
+{
+    bool inside = false;
+    for (size_t i = 0, j = n - 1; i < n; j = i++)
+    {
+        double xi = v[i].getX(), yi = v[i].getY();
+        double xj = v[j].getX(), yj = v[j].getY();
+        double cross = (xj - xi) * (y - yi) - (yj - yi) * (x - xi);
+        if (cross == 0 && min(xi, xj) <= x && x <= max(xi, xj) && min(yi, yj) <= y && y <= max(yi, yj))
+        {
+            return 0;
+        }
+        if ((yi > y) != (yj > y) && x < (xj - xi) * (y - yi) / (yj - yi) + xi)
+        {
+            inside = !inside;
+        }
+    }
+    return inside ? 1 : -1;
+}
+
+/**
+ * @brief Find a point strictly inside a polygon: on a horizontal line between the two lowest distinct heights of vertices, the middle of the first inside interval
+ * 
+ * @return bool false if the polygon is flat
+ */
+template <typename T, typename U>
+bool findInteriorPoint(const Point2D<T, U>* v, size_t n, double& x, double& y)
+{
+    double lowest = numeric_limits<double>::infinity();
+    for (size_t i = 0; i < n; i++)
+    {
+        lowest = min(lowest, static_cast<double>(v[i].getY()));
+    }
+    double next = numeric_limits<double>::infinity();
+    for (size_t i = 0; i < n; i++)
+    {
+        if (v[i].getY() > lowest)
+        {
+            next = min(next, static_cast<double>(v[i].getY()));
+        }
+    }
+    if (next == numeric_limits<double>::infinity())
+    {
+        return false;
+    }
+    y = (lowest + next) / 2; // no vertex at this height
+    vector<double> crossings;
+    for (size_t i = 0, j = n - 1; i < n; j = i++)
+    {
+        double xi = v[i].getX(), yi = v[i].getY();
+        double xj = v[j].getX(), yj = v[j].getY();
+        if ((yi > y) != (yj > y))
+        {
+            crossings.push_back((xj - xi) * (y - yi) / (yj - yi) + xi);
+        }
+    }
+    if (crossings.size() < 2)
+    {
+        return false;
+    }
+    sort(crossings.begin(), crossings.end());
+    x = (crossings[0] + crossings[1]) / 2;
+    return true;
+}
+
+/**
+ * @brief Check if some point of a (a vertex, the middle of an edge or an interior point) is strictly inside b
+ * 
+ */
+template <typename T, typename U>
+bool hasPointInside(const Point2D<T, U>* a, size_t na, const Point2D<T, U>* b, size_t nb)
+{
+    for (size_t i = 0; i < na; i++)
+    {
+        const Point2D<T, U>& p = a[i];
+        const Point2D<T, U>& q = a[(i + 1) % na];
+        if (locatePoint(b, nb, p.getX(), p.getY()) > 0 || locatePoint(b, nb, (static_cast<double>(p.getX()) + q.getX()) / 2, (static_cast<double>(p.getY()) + q.getY()) / 2) > 0)
+        {
+            return true;
+        }
+    }
+    double x, y;
+    return findInteriorPoint(a, na, x, y) && locatePoint(b, nb, x, y) > 0;
+}
+
+/**
+ * @brief Check if the interiors of two simple polygons overlap. Polygons only sharing edges or vertices, like neighbouring plots, do not overlap.
+ * They overlap if two edges cross properly, or if a vertex, the middle of an edge or an interior point of one of them is strictly inside the other
+ * 
+ * @tparam T 
+ * @tparam U 
+ * @param a vertices of the first polygon
+ * @param na 
+ * @param b vertices of the second polygon
+ * @param nb 
+ * @return bool 
+ */
+template <typename T, typename U>
+bool polygonsOverlap(const Point2D<T, U>* a, size_t na, const Point2D<T, U>* b, size_t nb)
+{
+    if (na < 3 || nb < 3)
+    {
+        return false;
+    }
+    for (size_t i = 0; i < na; i++)
+    {
+        const Point2D<T, U>& p = a[i];
+        const Point2D<T, U>& q = a[(i + 1) % na];
+        for (size_t j = 0; j < nb; j++)
+        {
+            const Point2D<T, U>& r = b[j];
+            const Point2D<T, U>& s = b[(j + 1) % nb];
+            if (orientation(p, q, r) * orientation(p, q, s) < 0 && orientation(r, s, p) * orientation(r, s, q) < 0)
+            {
+                return true;
+            }
+        }
+    }
+    return hasPointInside(a, na, b, nb) || hasPointInside(b, nb, a, na);
+}
+
+/**
+ * @brief The EdgeIndex class keeps the x ranges of the edges of a polygon in an interval tree, so that the edges whose x range overlaps a new edge can be found without looking at all of them.
+ * The tree is a treap ordered by the smallest x of the edges, each node also keeps the largest x of its subtree: a query only goes down the subtrees that can overlap it, whatever the width of the other edges.
+ * It is used to check only the edges created by Polygon::addVertex()
+ * 
+ */
+class EdgeIndex
+{
+    private:
+        struct Node
+        {
+            double low; // smallest x of the edge, the key of the tree
+            double high; // largest x of the edge
+            double maxHigh; // largest x of the subtree
+            size_t edge;
+            unsigned priority; // the parent has the highest priority, which keeps the tree balanced on average
+            int left;
+            int right;
+        };
+        vector<Node> nodes; // erased nodes are reused through freeNodes
+        vector<int> freeNodes;
+        int root;
+        unsigned seed; // fixed seed, the shape of the tree is the same on every run
+
+        bool before(const Node& a, double low, size_t edge) const
+        {
+            return a.low < low || (a.low == low && a.edge < edge);
+        }
+
+        void update(int t)
+        {
+            Node& node = nodes[t];
+            node.maxHigh = node.high;
+            if (node.left >= 0)
+            {
+                node.maxHigh = max(node.maxHigh, nodes[node.left].maxHigh);
+            }
+            if (node.right >= 0)
+            {
+                node.maxHigh = max(node.maxHigh, nodes[node.right].maxHigh);
+            }
+        }
+
+        int merge(int a, int b)
+        {
+            if (a < 0 || b < 0)
+            {
+                return a < 0 ? b : a;
+            }
+            if (nodes[a].priority > nodes[b].priority)
+            {
+                nodes[a].right = merge(nodes[a].right, b);
+                update(a);
+                return a;
+            }
+            nodes[b].left = merge(a, nodes[b].left);
+            update(b);
+            return b;
+        }
+
+        int insertNode(int t, int n)
+        {
+            if (t < 0)
+            {
+                return n;
+            }
+            if (nodes[n].priority > nodes[t].priority)
+            {
+                // n becomes the root of this subtree, the nodes of t are split around its key
+                split(t, nodes[n].low, nodes[n].edge, nodes[n].left, nodes[n].right);
+                update(n);
+                return n;
+            }
+            if (before(nodes[n], nodes[t].low, nodes[t].edge))
+            {
+                nodes[t].left = insertNode(nodes[t].left, n);
+            }
+            else
+            {
+                nodes[t].right = insertNode(nodes[t].right, n);
+            }
+            update(t);
+            return t;
+        }
+
+        void split(int t, double low, size_t edge, int& left, int& right)
+        {
+            if (t < 0)
+            {
+                left = right = -1;
+                return;
+            }
+            if (before(nodes[t], low, edge))
+            {
+                split(nodes[t].right, low, edge, nodes[t].right, right);
+                left = t;
+            }
+            else
+            {
+                split(nodes[t].left, low, edge, left, nodes[t].left);
+                right = t;
+            }
+            update(t);
+        }
+
+        int eraseNode(int t, double low, size_t edge)
+        {
+            if (t < 0)
+            {
+                return t;
+            }
+            if (nodes[t].low == low && nodes[t].edge == edge)
+            {
+                freeNodes.push_back(t);
+                return merge(nodes[t].left, nodes[t].right);
+            }
+            if (before(nodes[t], low, edge))
+            {
+                nodes[t].right = eraseNode(nodes[t].right, low, edge);
+            }
+            else
+            {
+                nodes[t].left = eraseNode(nodes[t].left, low, edge);
+            }
+            update(t);
+            return t;
+        }
+
+        template <typename F>
+        bool visitNode(int t, double low, double high, F& visit) const
+        {
+            if (t < 0 || nodes[t].maxHigh < low)
+            {
+                return false; // every edge of the subtree ends before the range
+            }
+            const Node& node = nodes[t];
+            if (visitNode(node.left, low, high, visit))
+            {
+                return true;
+            }
+            if (node.low > high)
+            {
+                return false; // this edge and the right subtree start after the range
+            }
+            if (node.high >= low && visit(node.edge))
+            {
+                return true;
+            }
+            return visitNode(node.right, low, high, visit);
+        }
+
+    public:
+        EdgeIndex() : root(-1), seed(2463534242u) {}
+
+        void clear()
+        {
+            nodes.clear();
+            freeNodes.clear();
+            root = -1;
+        }
+
+        void insert(size_t edge, double x1, double x2)
+        {
+            seed ^= seed << 13; // xorshift
+            seed ^= seed >> 17;
+            seed ^= seed << 5;
+            Node node{min(x1, x2), max(x1, x2), max(x1, x2), edge, seed, -1, -1};
+            int n;
+            if (freeNodes.empty())
+            {
+                n = static_cast<int>(nodes.size());
+                nodes.push_back(node);
+            }
+            else
+            {
+                n = freeNodes.back();
+                freeNodes.pop_back();
+                nodes[n] = node;
+            }
+            root = insertNode(root, n);
+        }
+
+        void erase(size_t edge, double x1, double x2)
+        {
+            root = eraseNode(root, min(x1, x2), edge);
+        }
+
+        /**
+         * @brief Call visit(edge) for every indexed edge whose x range overlaps [x1, x2], stopping as soon as visit returns true
+         * 
+         * @return bool true if visit returned true
+         */
+        template <typename F>
+        bool visitOverlapping(double x1, double x2, F visit) const
+        {
+            return visitNode(root, min(x1, x2), max(x1, x2), visit);
+        }
+};
+
+#endif // INTERSECTION_HPP
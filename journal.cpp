@@ -0,0 +1,360 @@
+/**
+ * @file journal.cpp
+ * @author Bastien, Victor, AlexisR 
+ * @brief Implementation file for the Journal class
+ * @version 0.1
+ * @date 2024-01-16
+ * 
+ * @copyright Copyright (c) 2024
+ * 
+ */
+
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <stdexcept>
+#include <unistd.h>
+#include "journal.hpp"
+#include "parser.hpp"
+
+using namespace std;
+
+/**
+ * @brief Construct a new closed Journal::Journal object
+ * 
+ */
+Journal::Journal() : fd(-1), sync(false), entryCount(0)
+{
+}
+
+/**
+ * @brief Construct a new Journal::Journal object appending to a file, see open()
+ * 
+ * @param filename 
+ * @param sync if true, every change is flushed to the disk before append() returns
+ */
+Journal::Journal(const string& filename, bool sync) : Journal()
+{
+    open(filename, sync);
+}
+
+/**
+ * @brief Destroy the Journal::Journal object, closing the file
+ * 
+ */
+Journal::~Journal()
+{
+    close();
+}
+
+/**
+ * @brief Open a file to append changes to it, creating it if needed. A last line cut by a crash is removed first. Throws an exception if the file cannot be opened
+ * 
+ * @param filename 
+ * @param sync if true, every change is flushed to the disk before append() returns
+ */
+void Journal::open(const string& filename, bool sync)
+{
+    close();
+    int fd = ::open(filename.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+    if (fd < 0)
+    {
+        throw runtime_error("Unable to open file " + filename);
+    }
+    size_t entryCount = 0;
+    {
+        MappedFile file(filename);
+        if (file.getSize() > 0)
+        {
+            entryCount = count(file.begin(), file.end(), '\n');
+            if (file.end()[-1] != '\n')
+            {
+                const void* newline = memrchr(file.begin(), '\n', file.getSize());
+                off_t length = newline ? static_cast<const char*>(newline) - file.begin() + 1 : 0;
+                if (ftruncate(fd, length) != 0)
+                {
+                    ::close(fd);
+                    throw runtime_error("Unable to repair file " + filename);
+                }
+            }
+        }
+    }
+    this->filename = filename;
+    this->fd = fd;
+    this->sync = sync;
+    this->entryCount = entryCount;
+}
+
+/**
+ * @brief Close the file. Nothing can be appended until the journal is opened again
+ * 
+ */
+void Journal::close()
+{
+    if (this->fd >= 0)
+    {
+        ::close(this->fd);
+        this->fd = -1;
+    }
+}
+
+/**
+ * @brief Check if changes can be appended
+ * 
+ * @return bool 
+ */
+bool Journal::isOpen() const
+{
+    return this->fd >= 0;
+}
+
+/**
+ * @brief Get the name of the file of the journal
+ * 
+ * @return const string& 
+ */
+const string& Journal::getFilename() const
+{
+    return this->filename;
+}
+
+/**
+ * @brief Get the number of changes in the file
+ * 
+ * @return size_t 
+ */
+size_t Journal::getEntryCount() const
+{
+    return this->entryCount;
+}
+
+/**
+ * @brief Append a number to a string with to_chars, in the shortest form that reads back to the same value
+ * 
+ */
+template <typename N>
+static void appendNumber(string& line, N value)
+{
+    char digits[32];
+    line.append(digits, to_chars(digits, digits + sizeof(digits), value).ptr);
+}
+
+/**
+ * @brief Append a change at the end of the file. Throws an exception if the journal is closed or the file cannot be written
+ * 
+ * @param entry 
+ */
+void Journal::append(const JournalEntry& entry)
+{
+    if (this->fd < 0)
+    {
+        throw logic_error("The journal is not open");
+    }
+    string& line = this->line;
+    line.clear();
+    static const char* const keywords[] = {"OWNER ", "SHAPE ", "TYPE ", "BUILT "};
+    line += keywords[entry.operation];
+    appendNumber(line, entry.number);
+    line += ' ';
+    switch (entry.operation)
+    {
+        case SET_OWNER:
+            line += entry.owner;
+            break;
+        case SET_SHAPE:
+            for (const auto& vertex : entry.vertices)
+            {
+                line += '[';
+                appendNumber(line, vertex.getX());
+                line += ';';
+                appendNumber(line, vertex.getY());
+                line += "] ";
+            }
+            break;
+        case SET_TYPE:
+            line += PlotTypeToString(entry.type);
+            if (entry.type == PlotType::URBAN_ZONE)
+            {
+                line += ' ';
+                appendNumber(line, entry.builtArea);
+            }
+            else if (entry.type == PlotType::AGRICULTURAL_ZONE)
+            {
+                line += ' ';
+                line += entry.cropType;
+            }
+            break;
+        case SET_BUILT_AREA:
+            appendNumber(line, entry.builtArea);
+            break;
+    }
+    line += '\n';
+
+    const char* data = line.data();
+    size_t size = line.size();
+    while (size > 0) // O_APPEND: a partial write is continued at the new end of the file
+    {
+        ssize_t n = write(this->fd, data, size);
+        if (n < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            throw runtime_error("Unable to write file " + this->filename);
+        }
+        data += n;
+        size -= n;
+    }
+    if (this->sync && fdatasync(this->fd) != 0)
+    {
+        throw runtime_error("Unable to write file " + this->filename);
+    }
+    this->entryCount++;
+}
+
+/**
+ * @brief Rename the file of the journal, with all its changes, then start again with an empty file under the old name. Throws an exception if the journal is closed or the file cannot be renamed
+ * 
+ * @param segment new name of the changes written so far
+ */
+void Journal::rotate(const string& segment)
+{
+    if (this->fd < 0)
+    {
+        throw logic_error("The journal is not open");
+    }
+    close();
+    bool renamed = rename(this->filename.c_str(), segment.c_str()) == 0;
+    open(this->filename, this->sync);
+    if (!renamed)
+    {
+        throw runtime_error("Unable to rename file " + this->filename);
+    }
+}
+
+/**
+ * @brief Get the next whitespace-separated token of a line and move p after it. Returns an empty view at the end of the line
+ * 
+ */
+static string_view nextToken(const char*& p, const char* end)
+{
+    while (p < end && (*p == ' ' || *p == '\r'))
+    {
+        p++;
+    }
+    const char* start = p;
+    while (p < end && *p != ' ' && *p != '\r')
+    {
+        p++;
+    }
+    return string_view(start, p - start);
+}
+
+/**
+ * @brief Read a number token
+ * 
+ * @return bool false if the token is missing or is not a number
+ */
+template <typename N>
+static bool readNumber(const char*& p, const char* end, N& value)
+{
+    string_view token = nextToken(p, end);
+    from_chars_result result = from_chars(token.data(), token.data() + token.size(), value);
+    return !token.empty() && result.ec == errc() && result.ptr == token.data() + token.size();
+}
+
+/**
+ * @brief Parse one line of a journal
+ * 
+ * @return bool false if the line is not a change
+ */
+static bool parseEntry(const char* p, const char* end, JournalEntry& entry)
+{
+    string_view keyword = nextToken(p, end);
+    if (!readNumber(p, end, entry.number))
+    {
+        return false;
+    }
+    if (keyword == "OWNER")
+    {
+        entry.operation = SET_OWNER;
+        entry.owner = string(nextToken(p, end));
+        return !entry.owner.empty();
+    }
+    if (keyword == "SHAPE")
+    {
+        entry.operation = SET_SHAPE;
+        parseVertices(p, end, entry.vertices);
+        return true;
+    }
+    if (keyword == "BUILT")
+    {
+        entry.operation = SET_BUILT_AREA;
+        return readNumber(p, end, entry.builtArea);
+    }
+    if (keyword != "TYPE")
+    {
+        return false;
+    }
+    entry.operation = SET_TYPE;
+    string_view type = nextToken(p, end);
+    if (type == "ZU")
+    {
+        entry.type = PlotType::URBAN_ZONE;
+        return readNumber(p, end, entry.builtArea);
+    }
+    else if (type == "ZAU")
+    {
+        entry.type = PlotType::ZONE_TO_BE_URBANIZED;
+    }
+    else if (type == "ZN")
+    {
+        entry.type = PlotType::NATURAL_AND_FOREST_ZONE;
+    }
+    else if (type == "ZA")
+    {
+        entry.type = PlotType::AGRICULTURAL_ZONE;
+        entry.cropType = string(nextToken(p, end));
+        return !entry.cropType.empty();
+    }
+    else
+    {
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Read all the changes of a journal file, in order. A missing file is an empty journal. Throws an exception if a complete line is not a change
+ * 
+ * @param filename 
+ * @return vector<JournalEntry> 
+ */
+vector<JournalEntry> Journal::read(const string& filename)
+{
+    vector<JournalEntry> entries;
+    MappedFile file(filename);
+    const char* p = file.begin();
+    size_t lineNumber = 0;
+    while (p < file.end())
+    {
+        const char* newline = static_cast<const char*>(memchr(p, '\n', file.end() - p));
+        if (!newline)
+        {
+            break; // cut by a crash while it was appended
+        }
+        lineNumber++;
+        JournalEntry entry;
+        if (!parseEntry(p, newline, entry))
+        {
+            throw runtime_error("Invalid change at line " + to_string(lineNumber) + " of " + filename);
+        }
+        entries.push_back(move(entry));
+        p = newline + 1;
+    }
+    return entries;
+}
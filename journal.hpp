@@ -0,0 +1,76 @@
+/**
+ * @file journal.hpp
+ * @author Bastien, Victor, AlexisR 
+ * @brief Header file for the Journal class, the append-only log of the changes made to the plots of a map
+ * @version 0.1
+ * @date 2024-01-16
+ * 
+ * @copyright Copyright (c) 2024
+ * 
+ */
+
+#include <string>
+#include <vector>
+#include "plot.hpp"
+
+#ifndef JOURNAL_HPP
+#define JOURNAL_HPP
+
+using namespace std;
+
+/**
+ * @brief The JournalOperation enum lists the changes of a plot that are journaled
+ * 
+ */
+enum JournalOperation {
+    SET_OWNER, // OWNER number owner
+    SET_SHAPE, // SHAPE number [x;y] [x;y] ...
+    SET_TYPE, // TYPE number ZU builtArea, TYPE number ZAU, TYPE number ZN or TYPE number ZA cropType
+    SET_BUILT_AREA // BUILT number builtArea
+};
+
+/**
+ * @brief The JournalEntry struct is one change of a plot, found by its number. An entry holds the new value and not a difference, so replaying an entry that was already applied changes nothing
+ * 
+ */
+struct JournalEntry
+{
+    JournalOperation operation = SET_OWNER;
+    int number = 0;
+    string owner; // SET_OWNER
+    vector<Point2D<int, float>> vertices; // SET_SHAPE
+    PlotType type = URBAN_ZONE; // SET_TYPE
+    float builtArea = 0; // SET_TYPE to an urban zone, and SET_BUILT_AREA
+    string cropType; // SET_TYPE to an agricultural zone
+};
+
+/**
+ * @brief The Journal class appends changes to a log file, one line per change, in a single write() each: saving a change costs the size of the change, not the size of the map.
+ * The floats are written with as many digits as needed to read back the same value. A last line cut by a crash is not a change: it is ignored by read() and removed by open()
+ * 
+ */
+class Journal
+{
+    private:
+        string filename;
+        int fd;
+        bool sync;
+        size_t entryCount;
+        string line; // reused by append()
+    public:
+        Journal();
+        Journal(const string& filename, bool sync = false);
+        Journal(const Journal& j) = delete;
+        Journal& operator=(const Journal& j) = delete;
+        ~Journal();
+        void open(const string& filename, bool sync = false);
+        void close();
+        bool isOpen() const;
+        const string& getFilename() const;
+        size_t getEntryCount() const;
+        void append(const JournalEntry& entry);
+        void rotate(const string& segment);
+        static vector<JournalEntry> read(const string& filename);
+};
+
+#endif // JOURNAL_HPP
@@ -0,0 +1,341 @@
+/**
+ * @file lazymap.cpp
+ * @author Bastien, Victor, AlexisR 
+ * @brief Implementation file for the LazyMap class
+ * @version 0.1
+ * @date 2024-01-16
+ * 
+ * @copyright Copyright (c) 2024
+ * 
+ */
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <sys/stat.h>
+#include "lazymap.hpp"
+
+using namespace std;
+
+/**
+ * @brief Layout of a sidecar index, all integers in the byte order of the machine that wrote it: an IndexHeader, then entryCount LazyMap::IndexEntry sorted by number.
+ * The header records the size and modification time of the indexed file, so that an index left by an older version of the file is not used
+ * 
+ */
+static const char INDEX_MAGIC[4] = {'C', 'A', 'D', 'I'};
+static const uint32_t INDEX_VERSION = 1;
+static const uint32_t INDEX_BYTE_ORDER = 0x01020304;
+
+struct IndexHeader
+{
+    char magic[4];
+    uint32_t version;
+    uint32_t byteOrder;
+    uint32_t reserved;
+    uint64_t fileSize;
+    int64_t fileModified; // in nanoseconds since the epoch
+    uint64_t entryCount;
+};
+
+/**
+ * @brief Get the modification time of a file
+ * 
+ * @return int64_t in nanoseconds since the epoch, -1 if the file does not exist
+ */
+static int64_t modificationTime(const string& filename)
+{
+    struct stat info;
+    if (stat(filename.c_str(), &info) != 0)
+    {
+        return -1;
+    }
+    return static_cast<int64_t>(info.st_mtim.tv_sec) * 1000000000 + info.st_mtim.tv_nsec;
+}
+
+/**
+ * @brief Construct a new LazyMap::LazyMap object. The file is mapped and indexed, no plot is parsed
+ * 
+ * @param filename file in the text format
+ * @param maxResidentPlots number of plots kept in memory, 0 for no limit
+ */
+LazyMap::LazyMap(const string& filename, size_t maxResidentPlots) : filename(filename), file(filename), indexLoaded(false), maxResidentPlots(maxResidentPlots), loadCount(0), evictionCount(0)
+{
+    if (!this->file.isOpen())
+    {
+        cout << "Unable to open file" << endl;
+        return;
+    }
+    this->indexLoaded = loadIndex();
+    if (!this->indexLoaded)
+    {
+        scan();
+    }
+}
+
+/**
+ * @brief Record the offset of every record of the file, in one pass that only reads the header lines
+ * 
+ */
+void LazyMap::scan()
+{
+    RecordScanner scanner(this->file.begin(), this->file.end());
+    PlotRecord record;
+    const char* start = scanner.getPosition();
+    while (scanner.next(record))
+    {
+        if (record.type == "ZU" || record.type == "ZAU" || record.type == "ZN" || record.type == "ZA")
+        {
+            this->index.push_back(IndexEntry{record.number, 0, static_cast<uint64_t>(start - this->file.begin())});
+        }
+        start = scanner.getPosition();
+    }
+    sort(this->index.begin(), this->index.end(), [](const IndexEntry& a, const IndexEntry& b) {
+        return a.number < b.number || (a.number == b.number && a.offset < b.offset);
+    });
+}
+
+/**
+ * @brief Read the sidecar index, if it exists and was written for the current version of the file
+ * 
+ * @return bool false if it cannot be used
+ */
+bool LazyMap::loadIndex()
+{
+    MappedFile sidecar(getIndexFilename());
+    if (!sidecar.isOpen() || sidecar.getSize() < sizeof(IndexHeader))
+    {
+        return false;
+    }
+    IndexHeader header;
+    memcpy(&header, sidecar.begin(), sizeof(header));
+    if (memcmp(header.magic, INDEX_MAGIC, sizeof(header.magic)) != 0 || header.version != INDEX_VERSION || header.byteOrder != INDEX_BYTE_ORDER
+        || header.fileSize != this->file.getSize() || header.fileModified != modificationTime(this->filename)
+        || sidecar.getSize() != sizeof(header) + header.entryCount * sizeof(IndexEntry))
+    {
+        return false;
+    }
+    this->index.resize(header.entryCount);
+    memcpy(this->index.data(), sidecar.begin() + sizeof(header), header.entryCount * sizeof(IndexEntry));
+    for (const auto& entry : this->index)
+    {
+        if (entry.offset >= this->file.getSize())
+        {
+            this->index.clear();
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Write the sidecar index next to the file, so that the next LazyMap opened on the file does not scan it
+ * 
+ * @return bool false if it cannot be written
+ */
+bool LazyMap::saveIndex() const
+{
+    IndexHeader header;
+    memcpy(header.magic, INDEX_MAGIC, sizeof(header.magic));
+    header.version = INDEX_VERSION;
+    header.byteOrder = INDEX_BYTE_ORDER;
+    header.reserved = 0;
+    header.fileSize = this->file.getSize();
+    header.fileModified = modificationTime(this->filename);
+    header.entryCount = this->index.size();
+    ofstream sidecar(getIndexFilename(), ios::binary | ios::trunc);
+    if (!sidecar.is_open())
+    {
+        cout << "Unable to open file" << endl;
+        return false;
+    }
+    sidecar.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    sidecar.write(reinterpret_cast<const char*>(this->index.data()), this->index.size() * sizeof(IndexEntry));
+    return sidecar.good();
+}
+
+/**
+ * @brief Get the name of the sidecar index of the file
+ * 
+ * @return string 
+ */
+string LazyMap::getIndexFilename() const
+{
+    return this->filename + ".idx";
+}
+
+/**
+ * @brief Check if the sidecar index was used instead of scanning the file
+ * 
+ * @return bool 
+ */
+bool LazyMap::isIndexLoaded() const
+{
+    return this->indexLoaded;
+}
+
+/**
+ * @brief Check if the file could be opened and mapped
+ * 
+ * @return bool 
+ */
+bool LazyMap::isOpen() const
+{
+    return this->file.isOpen();
+}
+
+/**
+ * @brief Get the number of plots of the file, resident or not
+ * 
+ * @return size_t 
+ */
+size_t LazyMap::getPlotCount() const
+{
+    return this->index.size();
+}
+
+/**
+ * @brief Find the first record of a plot, by binary search
+ * 
+ */
+const LazyMap::IndexEntry* LazyMap::findEntry(int number) const
+{
+    auto it = lower_bound(this->index.begin(), this->index.end(), number, [](const IndexEntry& entry, int n) { return entry.number < n; });
+    return it != this->index.end() && it->number == number ? &*it : nullptr;
+}
+
+/**
+ * @brief Check if the file has a plot, without parsing it
+ * 
+ * @param number 
+ * @return bool 
+ */
+bool LazyMap::contains(int number) const
+{
+    return findEntry(number) != nullptr;
+}
+
+/**
+ * @brief Parse the record starting at an offset of the file into a plot owning its shape
+ * 
+ */
+shared_ptr<const Plot> LazyMap::materialize(uint64_t offset) const
+{
+    RecordScanner scanner(this->file.begin() + offset, this->file.end());
+    PlotRecord record;
+    if (!scanner.next(record))
+    {
+        return nullptr;
+    }
+    pmr::vector<Point2D<int, float>> vertices(STATS_RESOURCE());
+    parseVertices(record.verticesBegin, record.verticesEnd, vertices);
+    unique_ptr<Polygon<int, float>> shape = make_unique<Polygon<int, float>>(move(vertices), false); // as loadPlots(), not checked for self-intersections
+    Plot* plot = createPlot(record, shape.get());
+    if (!plot)
+    {
+        return nullptr;
+    }
+    plot->setShape(move(shape)); // the plot owns its shape, and deletes it with itself
+    return shared_ptr<const Plot>(plot);
+}
+
+/**
+ * @brief Get a plot by number, parsing it on first use. It becomes the most recently used resident plot; the least recently used one is dropped if there are too many
+ * 
+ * @param number 
+ * @return shared_ptr<const Plot> nullptr if there is no such plot
+ */
+shared_ptr<const Plot> LazyMap::getPlot(int number)
+{
+    lock_guard<mutex> guard(this->lock);
+    auto it = this->resident.find(number);
+    if (it != this->resident.end())
+    {
+        this->recentlyUsed.splice(this->recentlyUsed.begin(), this->recentlyUsed, it->second.position);
+        return it->second.plot;
+    }
+    const IndexEntry* entry = findEntry(number);
+    if (!entry)
+    {
+        return nullptr;
+    }
+    shared_ptr<const Plot> plot = materialize(entry->offset);
+    if (!plot)
+    {
+        return nullptr;
+    }
+    this->loadCount++;
+    this->recentlyUsed.push_front(number);
+    this->resident.emplace(number, ResidentPlot{plot, this->recentlyUsed.begin()});
+    evict();
+    return plot;
+}
+
+/**
+ * @brief Drop the least recently used plots down to the limit
+ * 
+ */
+void LazyMap::evict()
+{
+    while (this->maxResidentPlots > 0 && this->resident.size() > this->maxResidentPlots)
+    {
+        this->resident.erase(this->recentlyUsed.back());
+        this->recentlyUsed.pop_back();
+        this->evictionCount++;
+    }
+}
+
+/**
+ * @brief Get the number of plots in memory
+ * 
+ * @return size_t 
+ */
+size_t LazyMap::getResidentCount() const
+{
+    lock_guard<mutex> guard(this->lock);
+    return this->resident.size();
+}
+
+/**
+ * @brief Get the limit of plots in memory
+ * 
+ * @return size_t 0 for no limit
+ */
+size_t LazyMap::getMaxResidentPlots() const
+{
+    lock_guard<mutex> guard(this->lock);
+    return this->maxResidentPlots;
+}
+
+/**
+ * @brief Set the limit of plots in memory, dropping the least recently used ones if there are too many
+ * 
+ * @param maxResidentPlots 0 for no limit
+ */
+void LazyMap::setMaxResidentPlots(size_t maxResidentPlots)
+{
+    lock_guard<mutex> guard(this->lock);
+    this->maxResidentPlots = maxResidentPlots;
+    evict();
+}
+
+/**
+ * @brief Get the number of plots parsed from the file since the map was opened, a plot parsed again after being dropped counting twice
+ * 
+ * @return size_t 
+ */
+size_t LazyMap::getLoadCount() const
+{
+    lock_guard<mutex> guard(this->lock);
+    return this->loadCount;
+}
+
+/**
+ * @brief Get the number of plots dropped to stay within the limit
+ * 
+ * @return size_t 
+ */
+size_t LazyMap::getEvictionCount() const
+{
+    lock_guard<mutex> guard(this->lock);
+    return this->evictionCount;
+}
@@ -0,0 +1,89 @@
+/**
+ * @file lazymap.hpp
+ * @author Bastien, Victor, AlexisR 
+ * @brief Header file for the LazyMap class, a map whose plots are read from the file only when they are asked for
+ * @version 0.1
+ * @date 2024-01-16
+ * 
+ * @copyright Copyright (c) 2024
+ * 
+ */
+
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "parser.hpp"
+#include "plot.hpp"
+
+#ifndef LAZYMAP_HPP
+#define LAZYMAP_HPP
+
+using namespace std;
+
+/**
+ * @brief The LazyMap class is the lazy counterpart of Map, for tools that only need a few plots of a large file in the text format. Opening it only records where each record starts, by plot number: one scan of the file, or reading the sidecar index written by saveIndex().
+ * A plot is parsed the first time it is asked for, then kept among the resident plots. Past the limit of resident plots, the least recently used one is dropped; a plot that is still used elsewhere lives on through its shared_ptr. A dropped plot parsed again is the same as before: createPlot() keeps stored values as they are, a built area of 0 included.
+ * The file stays mapped in memory, read only, so it must not change while the map is open
+ * 
+ */
+class LazyMap
+{
+    private:
+        /**
+         * @brief Position of the record of a plot in the file
+         * 
+         */
+        struct IndexEntry
+        {
+            int32_t number;
+            uint32_t reserved;
+            uint64_t offset;
+        };
+
+        /**
+         * @brief A plot in memory, and its place in the list of the resident plots
+         * 
+         */
+        struct ResidentPlot
+        {
+            shared_ptr<const Plot> plot;
+            list<int>::iterator position;
+        };
+        string filename;
+        MappedFile file;
+        vector<IndexEntry> index; // sorted by number, then by offset
+        bool indexLoaded; // read from the sidecar index rather than by a scan
+        mutable mutex lock; // guards the resident plots
+        unordered_map<int, ResidentPlot> resident;
+        list<int> recentlyUsed; // numbers of the resident plots, the most recently used first
+        size_t maxResidentPlots;
+        size_t loadCount;
+        size_t evictionCount;
+        void scan();
+        bool loadIndex();
+        const IndexEntry* findEntry(int number) const;
+        shared_ptr<const Plot> materialize(uint64_t offset) const;
+        void evict();
+    public:
+        LazyMap(const string& filename, size_t maxResidentPlots = 1 << 16);
+        LazyMap(const LazyMap& m) = delete;
+        LazyMap& operator=(const LazyMap& m) = delete;
+        bool isOpen() const;
+        size_t getPlotCount() const;
+        bool contains(int number) const;
+        shared_ptr<const Plot> getPlot(int number);
+        size_t getResidentCount() const;
+        size_t getMaxResidentPlots() const;
+        void setMaxResidentPlots(size_t maxResidentPlots);
+        size_t getLoadCount() const;
+        size_t getEvictionCount() const;
+        bool isIndexLoaded() const;
+        string getIndexFilename() const;
+        bool saveIndex() const;
+};
+
+#endif // LAZYMAP_HPP
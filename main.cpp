@@ -9,18 +9,32 @@
  * 
  */
 
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstring>
 #include <iostream>
+#include <sstream>
+#include <thread>
 #include "point2d.hpp"
 #include "polygon.hpp"
 #include "plot.hpp"
+#include "geometrybuffer.hpp"
+#include "parser.hpp"
+#include "binaryformat.hpp"
+#include "map.hpp"
+#include "concurrentmap.hpp"
+#include "lazymap.hpp"
+#include "plotstore.hpp"
+#include "stats.hpp"
+#include "textwriter.hpp"
 #include "cmath"
-#include "sstream"
 #include "fstream"
 
 using namespace std;
 
 vector<Plot*> textToPlots(string filename);
-void plotsToText(vector<Plot*> plots);
+void plotsToText(const PlotStore& store, const string& filename);
 
 int main()
 {
@@ -55,6 +69,8 @@ int main()
     cout << u0 << endl;
     poly0.addVertex(p4);
     cout << u0 << endl;
+    poly0.setVertex(2, Point2D<int, float>(200, 200)); // area is updated from the two edges touching the moved vertex
+    cout << u0 << endl;
 
     //Test ZoneToBeUrbanized
     Point2D<int, float> p5(100, 0);
@@ -70,6 +86,58 @@ int main()
     ZoneToBeUrbanized z0(2, "Bastien", &poly1, pbuildable);
     cout << z0 << endl;
 
+    //Test self-intersection, the polygon must be left unchanged
+    try {
+        poly1.addVertex(Point2D<int, float>(150, -50));
+    }
+    catch (const runtime_error& e) {
+        cout << "Error: " << e.what() << endl;
+    }
+    cout << poly1 << endl;
+
+    //Test setVertex out of range, on a polygon with vertices and on an empty one
+    Polygon<int, float> emptyPolygon;
+    for (Polygon<int, float>* shape : {&poly1, &emptyPolygon})
+    {
+        try {
+            shape->setVertex(shape->getVertexView().size(), Point2D<int, float>(0, 0));
+        }
+        catch (const out_of_range& e) {
+            cout << "Error: " << e.what() << endl;
+        }
+    }
+
+    //Test PolygonEditor, the edits are validated and seen by the plot once, on commit
+    {
+        PolygonEditor<int, float> editor = poly1.edit();
+        editor.insertVertex(3, Point2D<int, float>(150, 150));
+        editor.addVertex(Point2D<int, float>(90, 50));
+        editor.removeVertex(editor.size() - 1);
+        editor.moveVertex(1, Point2D<int, float>(210, 0));
+        uint64_t version = poly1.getVersion();
+        editor.commit();
+        cout << "Edited in " << poly1.getVersion() - version << " commit: " << poly1 << endl;
+        cout << z0 << endl;
+    }
+
+    //Test exact area, the running sum after incremental edits is the same as a recomputation starting from any vertex
+    {
+        vector<Point2D<int, float>> rotated = poly0.getVertices();
+        bool exact = true;
+        for (size_t i = 0; i < rotated.size(); i++)
+        {
+            rotate(rotated.begin(), rotated.begin() + 1, rotated.end());
+            exact = exact && Polygon<int, float>(rotated).getTwiceArea() == poly0.getTwiceArea();
+        }
+        vector<Point2D<double, double>> survey = {Point2D<double, double>(652310.1, 6862045.3), Point2D<double, double>(652410.7, 6862045.9),
+            Point2D<double, double>(652411.3, 6862146.1), Point2D<double, double>(652309.9, 6862145.7)};
+        Polygon<double, double> forward(survey);
+        reverse(survey.begin() + 1, survey.end());
+        Polygon<double, double> backward(survey);
+        exact = exact && forward.getTwiceArea() == -backward.getTwiceArea();
+        cout << "Exact area: " << forward.getSignedArea() << " m2, " << (exact ? "same" : "different") << " in any order" << endl;
+    }
+
     //Test AgriculturalZone
     Point2D<int, float> p13(0, 100);
     Point2D<int, float> p14(100, 100);
@@ -98,151 +166,444 @@ int main()
 
     //Test textToPlots
     vector<Plot*> plots = textToPlots("./plots/plots_short.txt");
-    for (auto plot : plots)
+
+    //Test PlotStore, each type of plot is printed as its own class without dynamic_cast
+    PlotStore store("./plots/plots_short.txt");
+    store.forEachPlot([](const auto& plot) { cout << plot << endl; });
+    cout << "Buildable area: " << store.getBuildableArea() << " m2" << endl;
+
+    //Test loadPlotsParallel, the plots must be the same and in the same order as with textToPlots
+    vector<Plot*> parallelPlots = loadPlotsParallel("./plots/plots.txt", 4);
+    vector<Plot*> sequentialPlots = textToPlots("./plots/plots.txt");
+    bool sameOrder = parallelPlots.size() == sequentialPlots.size();
+    for (size_t i = 0; sameOrder && i < parallelPlots.size(); i++)
     {
-        switch (plot->getType())
+        sameOrder = parallelPlots[i]->getNumber() == sequentialPlots[i]->getNumber() && parallelPlots[i]->getArea() == sequentialPlots[i]->getArea();
+    }
+    cout << "Parallel loading: " << parallelPlots.size() << " plots, " << (sameOrder ? "same as" : "different from") << " textToPlots" << endl;
+
+    //Test binary format, a round trip must give back the same plots
+    plotsToBinary(sequentialPlots, "./plots/plots_out.bin");
+    vector<Plot*> binaryPlots = binaryToPlots("./plots/plots_out.bin");
+    bool sameContent = binaryPlots.size() == sequentialPlots.size();
+    for (size_t i = 0; sameContent && i < binaryPlots.size(); i++)
+    {
+        Plot* a = sequentialPlots[i];
+        Plot* b = binaryPlots[i];
+        sameContent = a->getNumber() == b->getNumber() && a->getType() == b->getType() && a->getOwner() == b->getOwner()
+            && a->getPBuildable() == b->getPBuildable() && a->getArea() == b->getArea()
+            && a->getShape()->getVertexView().size() == b->getShape()->getVertexView().size();
+        for (size_t v = 0; sameContent && v < a->getShape()->getVertexView().size(); v++)
         {
-            case PlotType::URBAN_ZONE:
-                cout << *dynamic_cast<UrbanZone*>(plot) << endl;
-                break;
-            case PlotType::ZONE_TO_BE_URBANIZED:
-                cout << *dynamic_cast<ZoneToBeUrbanized*>(plot) << endl;
-                break;
-            case PlotType::NATURAL_AND_FOREST_ZONE:
-                cout << *dynamic_cast<NaturalAndForestZone*>(plot) << endl;
-                break;
-            case PlotType::AGRICULTURAL_ZONE:
-                cout << *dynamic_cast<AgriculturalZone*>(plot) << endl;
-                break;
-            default:
-                cout << *plot << endl;
-                break;
+            sameContent = a->getShape()->getVertexView()[v].getX() == b->getShape()->getVertexView()[v].getX()
+                && a->getShape()->getVertexView()[v].getY() == b->getShape()->getVertexView()[v].getY();
+        }
+        if (sameContent && a->getType() == PlotType::URBAN_ZONE)
+        {
+            sameContent = dynamic_cast<UrbanZone*>(a)->getBuiltArea() == dynamic_cast<UrbanZone*>(b)->getBuiltArea();
+        }
+        if (sameContent && a->getType() == PlotType::AGRICULTURAL_ZONE)
+        {
+            sameContent = dynamic_cast<AgriculturalZone*>(a)->getCropType() == dynamic_cast<AgriculturalZone*>(b)->getCropType();
         }
     }
+    cout << "Binary format: " << binaryPlots.size() << " plots, " << (sameContent ? "same as" : "different from") << " plots.txt" << endl;
 
-    //Test plotsToText
-    plotsToText(plots);
-    
-}
+    //Test binary format, a file with a broken last record gives no plots at all
+    {
+        ifstream in("./plots/plots_out.bin", ios::binary);
+        string bytes((istreambuf_iterator<char>(in)), istreambuf_iterator<char>());
+        in.close();
+        BinaryHeader header;
+        memcpy(&header, bytes.data(), sizeof(header));
+        uint64_t vertexCount = header.vertexCount + 1; // past the end of the vertex blob
+        memcpy(&bytes[header.recordsOffset + (header.plotCount - 1) * sizeof(BinaryPlotRecord) + offsetof(BinaryPlotRecord, vertexCount)], &vertexCount, sizeof(vertexCount));
+        ofstream out("./plots/broken.bin", ios::binary);
+        out.write(bytes.data(), bytes.size());
+        out.close();
+        vector<Plot*> brokenPlots = binaryToPlots("./plots/broken.bin");
+        cout << "Binary format, broken last record: " << brokenPlots.size() << " plots" << endl;
+        remove("./plots/broken.bin");
+    }
 
-Polygon<int, float>* createPolygons(string &line){
-    stringstream ss(line); // get the coordinates
-    int x, y;
-    char ch;
-    vector<Point2D<int, float>> vertices;
-    while (ss >> ch)
-    {
-        char semiColon;
-        ss  >> x >> semiColon >> y >> ch;
-        Point2D<int, float> p(x, y);
-        vertices.push_back(p);
-    }
-    Polygon<int, float>* shape = new Polygon<int, float>();
-    shape->setVertices(vertices);
-    return shape;
-}
+    //Test Map, all the plots are allocated in the arena of the map and released together
+    Map map("./plots/plots.txt");
+    cout << map;
+    Plot* found = map.findPlotAt(10, 100);
+    cout << "Plot at (10, 100): " << (found ? found->getNumber() : -1) << endl;
+    cout << "Plots in [(0, 0), (50, 50)]:";
+    for (auto plot : map.findPlotsIn(BoundingBox(0, 0, 50, 50)))
+    {
+        cout << " " << plot->getNumber();
+    }
+    cout << endl;
+    cout << "Plots of AMPLOI:";
+    for (auto plot : map.getPlotsOf("AMPLOI"))
+    {
+        cout << " " << plot->getNumber();
+    }
+    cout << endl;
+    cout << "Overlapping plots:";
+    for (auto overlap : map.findOverlaps())
+    {
+        cout << " (" << overlap.first << ", " << overlap.second << ")";
+    }
+    cout << endl;
 
-/**
- * @brief Function allowing to create a list of plots from a file
- * 
- * @param filename
- */
-vector<Plot*> textToPlots(string filename)
-{
-    vector<Plot*> plots;
-    ifstream file(filename);
-    string line, owner, type, crop;
-    int number, pBuildable;
-    float builtArea;
+    //Test findOverlaps on crafted plots: a partial overlap, a plot inside another and a duplicate are found, plots sharing only an edge are not
+    {
+        ofstream out("./plots/overlaps.txt");
+        out << "ZN 70 Victor \n[0;0] [100;0] [100;100] [0;100] \n" // the reference square
+            << "ZN 71 Victor \n[50;50] [150;50] [150;150] [50;150] \n" // overlaps a corner of 70
+            << "ZN 72 Victor \n[0;-100] [100;-100] [100;0] [0;0] \n" // shares the bottom edge of 70
+            << "ZN 73 Victor \n[10;10] [30;10] [30;30] [10;30] \n" // inside 70
+            << "ZN 74 Victor \n[0;0] [100;0] [100;100] [0;100] \n"; // same shape as 70
+        out.close();
+        Map crafted("./plots/overlaps.txt");
+        vector<pair<int, int>> expected = {{70, 71}, {70, 73}, {70, 74}, {71, 74}, {73, 74}};
+        vector<pair<int, int>> overlaps = crafted.findOverlaps();
+        cout << "Overlapping crafted plots:";
+        for (auto overlap : overlaps)
+        {
+            cout << " (" << overlap.first << ", " << overlap.second << ")";
+        }
+        cout << ", " << (overlaps == expected ? "as expected" : "not as expected") << endl;
+        remove("./plots/overlaps.txt");
+    }
 
-    if (file.is_open())
+    //Test Map aggregates, the totals must not depend on the number of threads
     {
-        while (getline(file, line))
+        MapAggregates sequential = map.aggregate(1);
+        MapAggregates parallel = map.aggregate(8);
+        bool sameTotals = sequential.total.twiceArea == parallel.total.twiceArea && sequential.total.buildableArea == parallel.total.buildableArea
+            && sequential.byOwner.size() == parallel.byOwner.size();
+        for (const auto& owner : sequential.byOwner)
         {
-            stringstream ss(line);
-            ss >> type >> number >> owner;
-            getline(file, line);
-            Polygon<int, float>* shape = createPolygons(line);
-            if (type == "ZU")
-            {
-                ss >> pBuildable >> builtArea >> builtArea;
-                UrbanZone* u = new UrbanZone(number, owner, shape, pBuildable, builtArea);
-                plots.push_back(u);
-            }
-            else if (type == "ZAU")
+            sameTotals = sameTotals && parallel.byOwner.count(owner.first) && parallel.byOwner[owner.first].twiceArea == owner.second.twiceArea
+                && parallel.byOwner[owner.first].buildableArea == owner.second.buildableArea;
+        }
+        cout << "Aggregates: " << sequential.total.plotCount << " plots, area " << sequential.total.getArea() << " m2, buildable " << sequential.total.getBuildableArea() << " m2, "
+            << (sameTotals ? "same" : "different") << " with 8 threads" << endl;
+        for (int type = 0; type < 4; type++)
+        {
+            cout << "\t" << PlotTypeToString(PlotType(type)) << ": " << sequential.byType[type].plotCount << " plots, area " << sequential.byType[type].getArea()
+                << " m2, buildable " << sequential.byType[type].getBuildableArea() << " m2" << endl;
+        }
+        cout << "\tAMPLOI: area " << sequential.getOwnerTotals("AMPLOI").getArea() << " m2" << endl;
+    }
+    map.clear();
+    cout << map << endl;
+
+    //Test validation, the report lists each broken rule once per plot, whatever the number of threads
+    {
+        vector<Point2D<int, float>> clockwise = {Point2D<int, float>(0, 0), Point2D<int, float>(0, 100), Point2D<int, float>(100, 100), Point2D<int, float>(100, 0)};
+        vector<Point2D<int, float>> large;
+        for (int i = 0; i < 20000; i++)
+        {
+            double angle = 2 * M_PI * i / 20000;
+            large.push_back(Point2D<int, float>(static_cast<int>(round(100000 * cos(angle))), static_cast<float>(round(100000 * sin(angle)))));
+        }
+        UrbanZone overbuilt(900, "Victor", Polygon<int, float>(vertices3), 10, 5000);
+        ZoneToBeUrbanized overPercent(901, "Victor", Polygon<int, float>(vertices3), 150);
+        NaturalAndForestZone reversed(902, "Victor", Polygon<int, float>(clockwise));
+        NaturalAndForestZone forest(903, "Victor", Polygon<int, float>(large));
+        vector<const Plot*> checked(sequentialPlots.begin(), sequentialPlots.end());
+        checked.insert(checked.begin() + 10, &forest);
+        checked.insert(checked.end(), {&overbuilt, &overPercent, &reversed});
+        ValidationReport report = validatePlots(checked.data(), checked.size(), 4);
+        ValidationReport sequentialReport = validatePlots(checked.data(), checked.size(), 1);
+        bool sameReport = report.errors.size() == sequentialReport.errors.size();
+        for (size_t i = 0; sameReport && i < report.errors.size(); i++)
+        {
+            sameReport = report.errors[i].index == sequentialReport.errors[i].index && report.errors[i].check == sequentialReport.errors[i].check;
+        }
+        cout << report;
+        cout << "Validation with 4 threads: " << (sameReport ? "same as" : "different from") << " 1 thread" << endl;
+    }
+
+    //Test validation on load, the invalid plots of a file are kept and listed in the report of the map, nothing is printed while loading
+    //and a clockwise plot has no area, in the aggregates as in the plot
+    {
+        ofstream out("./plots/invalid.txt");
+        out << "ZN 60 Victor \n[0;0] [100;100] [100;0] [0;100] \nZN 61 Victor \n[0;0] [50;50] [100;100] \nZN 62 Victor \n[0;0] [0;100] [100;100] [100;0] \n"
+            << "ZN 63 Victor \n[200;0] [300;0] [300;100] [200;100] \nZA 64 Victor blé\n[0;0] [50;50] [100;100] \n";
+        out.close();
+        Map invalid("./plots/invalid.txt");
+        cout << "Map with invalid plots: " << invalid.getPlots().size() << " plots kept" << endl;
+        cout << invalid.getValidationReport();
+        cout << "Map with invalid plots: agricultural zone of null area " << invalid.findPlot(64)->getPBuildable() << "% buildable" << endl;
+        double aggregatedArea = invalid.aggregate().total.getArea();
+        cout << "Map with a clockwise plot: total area " << invalid.getTotalArea() << " m2, aggregated " << aggregatedArea << " m2, "
+            << (aggregatedArea == invalid.getTotalArea() ? "same" : "different") << endl;
+        remove("./plots/invalid.txt");
+    }
+
+    //Test ConcurrentMap, readers running during the edits must each see one consistent snapshot
+    {
+        ConcurrentMap concurrent("./plots/plots.txt");
+        atomic<bool> editing(true);
+        atomic<int> inconsistent(0);
+        vector<thread> readers;
+        for (int r = 0; r < 4; r++)
+        {
+            readers.emplace_back([&]() {
+                uint64_t lastVersion = 0;
+                do
+                {
+                    MapReadGuard snapshot = concurrent.read();
+                    MapAggregates first = snapshot->aggregate(1);
+                    const Plot* found = snapshot->findPlotAt(10, 100);
+                    MapAggregates second = snapshot->aggregate(1);
+                    if (first.total.twiceArea != second.total.twiceArea || first.total.buildableArea != second.total.buildableArea
+                        || snapshot->getVersion() < lastVersion || (found && !found->getShape()->contains(10, 100)))
+                    {
+                        inconsistent++;
+                    }
+                    lastVersion = snapshot->getVersion();
+                } while (editing);
+            });
+        }
+        for (int i = 0; i < 20; i++)
+        {
+            MapEditor editor = concurrent.edit();
+            editor.translate(24, i % 2 ? -10 : 10, 0);
+            editor.setBuiltArea(1, 10 + i);
+            editor.commit();
+        }
+        {
+            MapEditor editor = concurrent.edit();
+            editor.reclassify(5, PlotType::URBAN_ZONE, 100); // the zone to be urbanized is built on
+            editor.reshape(101, {Point2D<int, float>(0, 0), Point2D<int, float>(50, 0), Point2D<int, float>(50, 50), Point2D<int, float>(0, 50)});
+            editor.commit();
+        }
+        editing = false;
+        for (auto& reader : readers)
+        {
+            reader.join();
+        }
+        MapReadGuard snapshot = concurrent.read();
+        MapAggregates totals = snapshot->aggregate();
+        cout << "Concurrent map: version " << snapshot->getVersion() << ", " << (inconsistent ? "inconsistent" : "consistent") << " snapshots, "
+            << totals.byType[PlotType::URBAN_ZONE].plotCount << " urban zones, plot 101 area " << snapshot->findPlot(101)->getArea() << " m2" << endl;
+        {
+            MapEditor editor = concurrent.edit();
+            editor.setBuiltArea(1, 0); // 0 is a value, not "unspecified"
+            editor.translate(1, 10, 0); // and it survives the rebuild of the plot
+            editor.commit();
+        }
+        MapReadGuard edited = concurrent.read();
+        cout << "Concurrent map: built area of plot 1 set to 0, read back " << dynamic_cast<const UrbanZone*>(edited->findPlot(1))->getBuiltArea() << " m2" << endl;
+    }
+
+    //Test journal, each change is appended as one line and replayed on the snapshot when the map is opened again; a compaction folds the changes into a new snapshot
+    {
+        ofstream out("./plots/journal_snapshot.txt");
+        out << "ZU 17 Martin 55 1003\n[0;30] [60;100] [0;100] \nZAU 25 Robert 16 \n[0;30] [80;30] [80;100] [60;100] \n";
+        out.close();
+        remove("./plots/journal.log");
+        auto describe = [](const Map& m) {
+            TextBuffer buffer;
+            for (auto plot : m.getPlots())
             {
-                ss >> pBuildable;
-                ZoneToBeUrbanized* z = new ZoneToBeUrbanized(number, owner, shape, pBuildable);
-                plots.push_back(z);
+                buffer.append(*plot);
             }
-            else if (type == "ZN")
+            return string(buffer.getData(), buffer.size());
+        };
+
+        Map edited;
+        edited.open("./plots/journal_snapshot.txt", "./plots/journal.log");
+        edited.setPlotOwner(17, "Victor");
+        edited.reshapePlot(25, {Point2D<int, float>(0, 30), Point2D<int, float>(80, 30), Point2D<int, float>(80, 110), Point2D<int, float>(60, 110)});
+        edited.reclassifyPlot(25, PlotType::URBAN_ZONE, 120.5f);
+        edited.setPlotBuiltArea(17, 0.25f);
+        Plot* moved = edited.findPlotAt(70, 105);
+        cout << "Journal: " << edited.getJournal().getEntryCount() << " changes, plot at (70, 105): " << (moved ? moved->getNumber() : -1) << " " << PlotTypeToString(moved ? moved->getType() : PlotType::URBAN_ZONE) << endl;
+
+        Map replayed;
+        replayed.open("./plots/journal_snapshot.txt", "./plots/journal.log");
+        cout << "Journal replayed: " << (describe(replayed) == describe(edited) ? "same plots" : "different plots") << endl;
+
+        edited.compact();
+        bool folded = edited.waitForCompaction();
+        Map compacted;
+        compacted.open("./plots/journal_snapshot.txt", "./plots/journal.log");
+        cout << "Journal compacted: " << (folded ? "done" : "failed") << ", " << compacted.getJournal().getEntryCount() << " changes left, " << (describe(compacted) == describe(edited) ? "same plots" : "different plots") << endl;
+
+        edited.setPlotBuiltArea(17, 0); // a stored 0 is not "unspecified": it must not become a random built area on reload
+        edited.compact();
+        edited.waitForCompaction();
+        Map reopened;
+        reopened.open("./plots/journal_snapshot.txt", "./plots/journal.log");
+        cout << "Journal compacted, built area of 17 after reload: " << dynamic_cast<const UrbanZone*>(reopened.findPlot(17))->getBuiltArea() << " m2" << endl;
+
+        ofstream torn("./plots/journal.log", ios::app);
+        torn << "OWNER 17 Rob"; // a change cut by a crash
+        torn.close();
+        Map recovered;
+        recovered.open("./plots/journal_snapshot.txt", "./plots/journal.log");
+        cout << "Journal with a cut change: " << recovered.getJournal().getEntryCount() << " changes, owner of 17: " << recovered.findPlot(17)->getOwner() << endl;
+
+        // an owner or crop type that could not be read back from the journal is refused before anything is changed, so the map can always be opened again
+        int refused = 0;
+        for (const string& owner : {string(""), string("Jean Dupont"), string("Jean\nDupont")})
+        {
+            try
             {
-                NaturalAndForestZone* n = new NaturalAndForestZone(number, owner, shape);
-                plots.push_back(n);
+                recovered.setPlotOwner(17, owner);
             }
-            else if (type == "ZA")
+            catch (const runtime_error& e)
             {
-                ss >> crop;
-                AgriculturalZone* a = new AgriculturalZone(number, owner, shape, crop);
-                plots.push_back(a);
+                refused++;
             }
         }
+        try
+        {
+            recovered.reclassifyPlot(17, "");
+        }
+        catch (const runtime_error& e)
+        {
+            refused++;
+        }
+        try
+        {
+            recovered.reclassifyPlot(17, PlotType::AGRICULTURAL_ZONE);
+        }
+        catch (const logic_error& e)
+        {
+            refused++;
+        }
+        recovered.reclassifyPlot(17, "Wheat");
+        Map reclassified;
+        reclassified.open("./plots/journal_snapshot.txt", "./plots/journal.log");
+        const Plot* wheat = reclassified.findPlot(17);
+        cout << "Journal: " << refused << " invalid changes refused, plot 17 after reload: " << PlotTypeToString(wheat->getType()) << " " << wheat->getOwner() << " "
+            << dynamic_cast<const AgriculturalZone*>(wheat)->getCropType() << endl;
+        recovered.clear();
+        remove("./plots/journal_snapshot.txt");
+        remove("./plots/journal.log");
     }
-    else
+
+    //Test LazyMap, a plot is parsed on first use only, at most 2 plots stay in memory, and the plots are the same as when the whole file is loaded
     {
-        cout << "Unable to open file" << endl;
+        remove("./plots/plots_short.txt.idx");
+        LazyMap lazy("./plots/plots_short.txt", 2);
+        cout << "Lazy map: " << lazy.getPlotCount() << " plots indexed, " << lazy.getResidentCount() << " resident" << endl;
+        shared_ptr<const Plot> first = lazy.getPlot(plots[0]->getNumber());
+        bool same = true;
+        for (auto plot : plots)
+        {
+            TextBuffer expected, loaded;
+            expected.append(*plot);
+            loaded.append(*lazy.getPlot(plot->getNumber()));
+            same = same && string(expected.getData(), expected.size()) == string(loaded.getData(), loaded.size());
+        }
+        cout << "Lazy map: " << (same ? "same plots" : "different plots") << ", " << lazy.getResidentCount() << " resident, " << lazy.getLoadCount() << " parsed, " << lazy.getEvictionCount() << " dropped" << endl;
+        cout << "Lazy map: evicted plot still usable: " << first->getNumber() << ", unknown plot: " << (lazy.getPlot(-1) ? "found" : "not found") << endl;
+        lazy.saveIndex();
+        LazyMap indexed("./plots/plots_short.txt", 2);
+        cout << "Lazy map: sidecar index " << (indexed.isIndexLoaded() ? "used" : "not used") << ", " << indexed.getPlotCount() << " plots indexed" << endl;
+        remove("./plots/plots_short.txt.idx");
+
+        // a plot parsed again after being dropped must be the same, even with a built area of 0
+        ofstream out("./plots/lazy.txt");
+        out << "ZU 17 Martin 55 0\n[0;30] [60;100] [0;100] \nZN 54 Savard \n[80;0] [100;0] [100;100] [80;100] \n";
+        out.close();
+        LazyMap single("./plots/lazy.txt", 1);
+        float before = dynamic_cast<const UrbanZone&>(*single.getPlot(17)).getBuiltArea();
+        single.getPlot(54);
+        float after = dynamic_cast<const UrbanZone&>(*single.getPlot(17)).getBuiltArea();
+        cout << "Lazy map: built area of 17 " << before << " m2, after reload " << after << " m2, " << single.getLoadCount() << " parsed" << endl;
+        remove("./plots/lazy.txt");
     }
-    return plots;
-}
 
-/**
- * @brief Function allowing to create a file from a list of plots
- * 
- * @param plots 
- */
-void plotsToText(vector<Plot*> plots){
-    ofstream file("./plots/plots_out.txt");
-    if (file.is_open())
+    //Test GeometryBuffer
+    GeometryBuffer<int, float> geometry;
+    for (auto plot : plots)
     {
-        for (auto plot : plots)
-        {   
-            file << PlotTypeToString(plot->getType()) << " " << plot->getNumber() << " " << plot->getOwner() << " ";
-            switch (plot->getType())
-            {
-                case PlotType::URBAN_ZONE:
-                {
-                    UrbanZone* zu = dynamic_cast<UrbanZone*>(plot);
-                    file << zu->getPBuildable() << " " << zu->getBuiltArea();
-                    break;
-                }
-                case PlotType::ZONE_TO_BE_URBANIZED:
-                {
-                    file << plot->getPBuildable();
-                    break;
-                }
-                case PlotType::NATURAL_AND_FOREST_ZONE:
-                    break;
-                case PlotType::AGRICULTURAL_ZONE:
-                {
-                    AgriculturalZone* za = dynamic_cast<AgriculturalZone*>(plot);
-                    file << za->getCropType();
-                    break;
-                }
-                default:
-                    break;
-            }
-            file << "\n";
-            for (auto vertex : plot->getShape()->getVertices())
-            {
-                file << "[" << vertex.getX() << ";" << vertex.getY() << "] ";
-            }
-            file << "\n";
+        geometry.addPolygon(*plot->getShape());
+    }
+    cout << "Geometry kernel: " << getGeometryKernelName() << endl;
+    for (size_t i = 0; i < geometry.getPolygonCount(); i++)
+    {
+        cout << "Plot " << plots[i]->getNumber() << ": area " << geometry.getSignedArea(i) << " m2, perimeter " << geometry.getPerimeter(i) << " m" << endl;
+    }
+
+    //Test plotsToText
+    plotsToText(store, "./plots/plots_out.txt");
+
+    //Test buffered text writer: same bytes as the stream writer, whatever the number of threads and the container of the plots
+    {
+        ostringstream expected;
+        store.writeText(expected);
+        auto readBack = []() {
+            ifstream in("./plots/plots_buffered.txt");
+            stringstream written;
+            written << in.rdbuf();
+            return written.str();
+        };
+        for (unsigned threadCount : {1u, 4u})
+        {
+            writePlotsText(store, "./plots/plots_buffered.txt", threadCount);
+            cout << "Buffered text writer, " << threadCount << " thread(s): " << (readBack() == expected.str() ? "same output" : "different output") << endl;
+        }
+        writePlotsText(plots, "./plots/plots_buffered.txt");
+        cout << "Buffered text writer, from plots: " << (readBack() == expected.str() ? "same output" : "different output") << endl;
+        remove("./plots/plots_buffered.txt");
+    }
+
+    //Test import without redundant copies: the vertices of each polygon are allocated once, exactly to their size, and never copied
+    {
+        Stats::reset();
+        vector<Plot*> imported = loadPlots("./plots/plots.txt");
+        size_t vertexCount = 0;
+        for (auto plot : imported)
+        {
+            vertexCount += plot->getShape()->getVertexView().size();
+        }
+        bool noCopies = Stats::get(ALLOCATIONS) == imported.size() && Stats::get(BYTES_ALLOCATED) == vertexCount * sizeof(Point2D<int, float>)
+            && Stats::get(POLYGONS_COPIED) == 0 && Stats::get(VERTICES_COPIED) == 0;
+        if (Stats::isEnabled())
+        {
+            cout << "Import: " << imported.size() << " polygons, " << Stats::get(ALLOCATIONS) << " vertex allocations, " << (noCopies ? "no" : "some") << " redundant copies" << endl;
+        }
+        for (auto plot : imported)
+        {
+            delete plot->getShape();
+            delete plot;
         }
     }
-    else
+
+    //Test Plot owning its shape, given by value or as a unique_ptr
     {
-        cout << "Unable to open file" << endl;
+        NaturalAndForestZone byValue(6, "Victor", Polygon<int, float>(vertices2));
+        AgriculturalZone byPointer(7, "Victor", make_unique<Polygon<int, float>>(vertices3), "Corn");
+        NaturalAndForestZone copied(byValue); // copies the owned shape
+        byValue.getShape()->setVertex(0, Point2D<int, float>(50, 100));
+        cout << byValue << endl << byPointer << endl << copied << endl;
     }
+
+    //Test Stats, the counters are only updated when compiled with CADASTRE_STATS
+    Stats::dumpText(cout);
+    
+}
+
+/**
+ * @brief Function allowing to create a list of plots from a file. The file is memory-mapped and parsed in place, see parser.hpp
+ * 
+ * @param filename
+ */
+vector<Plot*> textToPlots(string filename)
+{
+    return loadPlots(filename);
+}
+
+/**
+ * @brief Function allowing to create a file from the plots of a store, in the same order as the file they were loaded from
+ * 
+ * @param store 
+ */
+void plotsToText(const PlotStore& store, const string& filename){
+    writePlotsText(store, filename);
 }
 
 
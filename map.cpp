@@ -0,0 +1,934 @@
+/**
+ * @file map.cpp
+ * @author Bastien, Victor, AlexisR 
+ * @brief Implementation file for the Map class
+ * @version 0.1
+ * @date 2024-01-16
+ * 
+ * @copyright Copyright (c) 2024
+ * 
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <fcntl.h>
+#include <thread>
+#include <unistd.h>
+#include <unordered_map>
+#include "map.hpp"
+#include "parser.hpp"
+#include "textwriter.hpp"
+
+using namespace std;
+
+/**
+ * @brief Construct a new empty Map::Map object
+ * 
+ */
+Map::Map() : compactionThreshold(1 << 16)
+{
+}
+
+/**
+ * @brief Construct a new Map::Map object from a file in the text format
+ * 
+ * @param filename 
+ */
+Map::Map(const string& filename) : Map()
+{
+    load(filename);
+}
+
+/**
+ * @brief Destroy the Map::Map object, once the compaction is over. The arena releases all the plots at once
+ * 
+ */
+Map::~Map()
+{
+    waitForCompaction();
+}
+
+/**
+ * @brief Replace the plots of the map by the plots of a file in the text format
+ * 
+ * @param filename 
+ */
+void Map::load(const string& filename)
+{
+    clear();
+    this->plots = loadPlots(filename, &this->arena);
+    buildIndex();
+    indexOwners();
+    indexNumbers();
+    this->report = validate();
+}
+
+/**
+ * @brief Get the file holding the changes of a journal while they are folded into the snapshot
+ * 
+ */
+static string segmentOf(const string& journalFile)
+{
+    return journalFile + ".compacting";
+}
+
+/**
+ * @brief Load the plots of a snapshot file in the text format, replay the changes of its journal on them, then append the next changes to the journal.
+ * A journal left by an interrupted compaction is replayed first, then folded again. Throws an exception if a change cannot be replayed or the journal cannot be opened
+ * 
+ * @param snapshotFile 
+ * @param journalFile created if it does not exist
+ * @param sync if true, every change is flushed to the disk before it returns
+ */
+void Map::open(const string& snapshotFile, const string& journalFile, bool sync)
+{
+    load(snapshotFile);
+    string segment = segmentOf(journalFile);
+    bool interrupted = access(segment.c_str(), F_OK) == 0;
+    replay(segment);
+    replay(journalFile);
+    this->report = validate();
+    this->snapshotFile = snapshotFile;
+    this->journal.open(journalFile, sync);
+    if (interrupted)
+    {
+        compact();
+    }
+}
+
+/**
+ * @brief Apply the changes of a journal file, without journaling them again
+ * 
+ */
+void Map::replay(const string& journalFile)
+{
+    for (auto& entry : Journal::read(journalFile))
+    {
+        apply(entry, getPlot(entry.number));
+    }
+}
+
+/**
+ * @brief Remove all the plots, in a single release of the arena, and stop journaling
+ * 
+ */
+void Map::clear()
+{
+    waitForCompaction();
+    this->journal.close();
+    this->snapshotFile.clear();
+    this->plots.clear();
+    this->index.clear();
+    this->staleEntries.clear();
+    this->editedPlots.clear();
+    this->ownerIndex.clear();
+    this->numbers.clear();
+    this->report = ValidationReport();
+    this->arena.release();
+}
+
+/**
+ * @brief Get the plots of the map
+ * 
+ * @return const vector<Plot*>& 
+ */
+const vector<Plot*>& Map::getPlots() const
+{
+    return this->plots;
+}
+
+/**
+ * @brief Get the number of plots of the map
+ * 
+ * @return size_t 
+ */
+size_t Map::getPlotCount() const
+{
+    return this->plots.size();
+}
+
+/**
+ * @brief Get the total area of the map, i.e. the sum of the areas of its plots
+ * 
+ * @return float 
+ */
+float Map::getTotalArea() const
+{
+    double total = 0;
+    for (auto plot : this->plots)
+    {
+        total += plot->getArea();
+    }
+    return total;
+}
+
+/**
+ * @brief Add a plot to the totals. Its area is read from the exact shoelace sum of its shape; as in Plot::getArea(), a clockwise shape has no area
+ * 
+ * @param plot 
+ */
+void AreaTotals::add(const Plot& plot)
+{
+    this->plotCount++;
+    Shoelace<int, float>::Accumulator twiceArea = plot.getShape()->getTwiceArea();
+    this->twiceArea += twiceArea > 0 ? twiceArea : 0;
+    this->buildableArea += FixedPoint<float>::convert(plot.getBuildableArea());
+}
+
+/**
+ * @brief Add the totals of another group of plots
+ * 
+ * @param t 
+ */
+void AreaTotals::merge(const AreaTotals& t)
+{
+    this->plotCount += t.plotCount;
+    this->twiceArea += t.twiceArea;
+    this->buildableArea += t.buildableArea;
+}
+
+/**
+ * @brief Get the total area
+ * 
+ * @return double in square meters
+ */
+double AreaTotals::getArea() const
+{
+    return Shoelace<int, float>::toDouble(this->twiceArea) / 2;
+}
+
+/**
+ * @brief Get the total buildable area
+ * 
+ * @return double in square meters
+ */
+double AreaTotals::getBuildableArea() const
+{
+    return ldexp(static_cast<double>(this->buildableArea), -FixedPoint<float>::FRACTION_BITS);
+}
+
+/**
+ * @brief Add the totals of another part of the map
+ * 
+ * @param a 
+ */
+void MapAggregates::merge(const MapAggregates& a)
+{
+    this->total.merge(a.total);
+    for (int i = 0; i < 4; i++)
+    {
+        this->byType[i].merge(a.byType[i]);
+    }
+    for (const auto& owner : a.byOwner)
+    {
+        this->byOwner[owner.first].merge(owner.second);
+    }
+}
+
+/**
+ * @brief Get the totals of an owner
+ * 
+ * @param owner 
+ * @return const AreaTotals& null totals if the owner has no plot
+ */
+const AreaTotals& MapAggregates::getOwnerTotals(const string& owner) const
+{
+    static const AreaTotals none;
+    uint32_t id;
+    if (!StringPool::getInstance().find(owner, id))
+    {
+        return none;
+    }
+    auto it = this->byOwner.find(id);
+    return it == this->byOwner.end() ? none : it->second;
+}
+
+/**
+ * @brief Compute the totals of a range of plots
+ * 
+ */
+static void aggregateRange(const Plot* const* begin, const Plot* const* end, MapAggregates& result)
+{
+    AreaTotals* ownerTotals = nullptr;
+    uint32_t owner = 0;
+    for (const Plot* const* it = begin; it != end; it++)
+    {
+        const Plot& plot = **it;
+        AreaTotals totals;
+        totals.add(plot);
+        result.total.merge(totals);
+        result.byType[plot.getType()].merge(totals);
+        if (!ownerTotals || plot.getOwnerId() != owner) // consecutive plots often have the same owner
+        {
+            owner = plot.getOwnerId();
+            ownerTotals = &result.byOwner[owner];
+        }
+        ownerTotals->merge(totals);
+    }
+}
+
+/**
+ * @brief Compute the total area and buildable area of a list of plots, overall, by type of plot and by owner. The plots are split in contiguous ranges summed in parallel.
+ * The sums being exact, the result is the same whatever the number of threads. The areas of the plots are brought up to date on the way, so the plots must not be modified meanwhile
+ * 
+ * @param first the plots
+ * @param n number of plots
+ * @param threadCount number of threads, 0 for one per core
+ * @return MapAggregates 
+ */
+MapAggregates aggregatePlots(const Plot* const* first, size_t n, unsigned threadCount)
+{
+    if (threadCount == 0)
+    {
+        const size_t minChunkSize = 1 << 14; // below this, starting a thread costs more than summing
+        threadCount = static_cast<unsigned>(min<size_t>(max(1u, thread::hardware_concurrency()), n / minChunkSize + 1));
+    }
+
+    vector<MapAggregates> parts(threadCount);
+    vector<thread> workers;
+    for (unsigned i = 1; i < threadCount; i++)
+    {
+        workers.emplace_back(aggregateRange, first + n * i / threadCount, first + n * (i + 1) / threadCount, ref(parts[i]));
+    }
+    aggregateRange(first, first + n / threadCount, parts[0]);
+    for (auto& worker : workers)
+    {
+        worker.join();
+    }
+    for (unsigned i = 1; i < threadCount; i++)
+    {
+        parts[0].merge(parts[i]);
+    }
+    return move(parts[0]);
+}
+
+/**
+ * @brief Compute the totals of the map, see aggregatePlots()
+ * 
+ * @param threadCount number of threads, 0 for one per core
+ * @return MapAggregates 
+ */
+MapAggregates Map::aggregate(unsigned threadCount) const
+{
+    return aggregatePlots(this->plots.data(), this->plots.size(), threadCount);
+}
+
+/**
+ * @brief Check every plot of the map, see validatePlots()
+ * 
+ * @param threadCount number of threads, 0 for one per core
+ * @return ValidationReport 
+ */
+ValidationReport Map::validate(unsigned threadCount) const
+{
+    return validatePlots(this->plots.data(), this->plots.size(), threadCount);
+}
+
+/**
+ * @brief Get the errors found in the plots when the map was loaded
+ * 
+ * @return const ValidationReport& 
+ */
+const ValidationReport& Map::getValidationReport() const
+{
+    return this->report;
+}
+
+/**
+ * @brief Get the memory used by the map: the blocks of its arena and its list of plots
+ * 
+ * @return size_t in bytes
+ */
+size_t Map::getMemoryFootprint() const
+{
+    return this->arena.getBytesReserved() + this->plots.capacity() * sizeof(Plot*);
+}
+
+/**
+ * @brief Get the arena holding the plots, e.g. to inspect its usage
+ * 
+ * @return const Arena& 
+ */
+const Arena& Map::getArena() const
+{
+    return this->arena;
+}
+
+/**
+ * @brief Bulk-load the spatial index from the current shapes of the plots
+ * 
+ */
+void Map::buildIndex()
+{
+    this->staleEntries.clear();
+    this->editedPlots.clear();
+    vector<pair<BoundingBox, Plot*>> items;
+    items.reserve(this->plots.size());
+    for (auto plot : this->plots)
+    {
+        items.push_back(make_pair(plot->getShape()->getBoundingBox(), plot));
+    }
+    this->index.build(move(items));
+}
+
+/**
+ * @brief Find the plot containing the point (x, y). The index gives the few plots whose bounding box contains the point, then the exact shape is tested
+ * 
+ * @param x 
+ * @param y 
+ * @return Plot* nullptr if the point is outside every plot
+ */
+Plot* Map::findPlotAt(double x, double y) const
+{
+    Plot* found = nullptr;
+    this->index.searchPoint(x, y, [&](Plot* plot) {
+        if (!found && (this->staleEntries.empty() || !this->staleEntries.count(plot)) && plot->getShape()->contains(x, y))
+        {
+            found = plot;
+        }
+    });
+    for (size_t i = 0; !found && i < this->editedPlots.size(); i++)
+    {
+        if (this->editedPlots[i]->getShape()->contains(x, y))
+        {
+            found = this->editedPlots[i];
+        }
+    }
+    return found;
+}
+
+/**
+ * @brief Find the plots whose bounding box intersects a rectangle
+ * 
+ * @param box 
+ * @return vector<Plot*> 
+ */
+vector<Plot*> Map::findPlotsIn(const BoundingBox& box) const
+{
+    vector<Plot*> found;
+    this->index.search(box, [&](Plot* plot) {
+        if (this->staleEntries.empty() || !this->staleEntries.count(plot))
+        {
+            found.push_back(plot);
+        }
+    });
+    for (auto plot : this->editedPlots)
+    {
+        if (plot->getShape()->getBoundingBox().intersects(box))
+        {
+            found.push_back(plot);
+        }
+    }
+    return found;
+}
+
+/**
+ * @brief Find the pairs of plots whose shapes overlap, in near-linear time.
+ * The bounding boxes are hashed into a uniform grid whose cells have the average size of a plot, so each plot falls into a few cells. Only plots sharing a cell are compared, each pair once: in the cell holding the lower-left corner of the intersection of their boxes. The exact polygon test is only run on pairs whose boxes intersect
+ * 
+ * @return vector<pair<int, int>> numbers of the overlapping plots, sorted
+ */
+vector<pair<int, int>> Map::findOverlaps() const
+{
+    vector<pair<int, int>> overlaps;
+    size_t n = this->plots.size();
+    vector<BoundingBox> boxes(n);
+    double totalSize = 0;
+    for (size_t i = 0; i < n; i++)
+    {
+        boxes[i] = this->plots[i]->getShape()->getBoundingBox();
+        if (!boxes[i].isEmpty())
+        {
+            totalSize += max(boxes[i].maxX - boxes[i].minX, boxes[i].maxY - boxes[i].minY);
+        }
+    }
+    double cellSize = n > 0 && totalSize > 0 ? totalSize / n : 1;
+    auto cellOf = [cellSize](double v) { return static_cast<int64_t>(floor(v / cellSize)); };
+    auto key = [](int64_t cx, int64_t cy) { return static_cast<uint64_t>(cx) << 32 | static_cast<uint32_t>(cy); }; // exact for cells below 2^31 in each direction
+
+    unordered_map<uint64_t, vector<uint32_t>> grid;
+    grid.reserve(n * 2);
+    for (size_t i = 0; i < n; i++)
+    {
+        if (boxes[i].isEmpty())
+        {
+            continue;
+        }
+        for (int64_t cx = cellOf(boxes[i].minX); cx <= cellOf(boxes[i].maxX); cx++)
+        {
+            for (int64_t cy = cellOf(boxes[i].minY); cy <= cellOf(boxes[i].maxY); cy++)
+            {
+                grid[key(cx, cy)].push_back(static_cast<uint32_t>(i));
+            }
+        }
+    }
+
+    for (const auto& cell : grid)
+    {
+        const vector<uint32_t>& members = cell.second;
+        for (size_t a = 0; a < members.size(); a++)
+        {
+            for (size_t b = a + 1; b < members.size(); b++)
+            {
+                const BoundingBox& boxA = boxes[members[a]];
+                const BoundingBox& boxB = boxes[members[b]];
+                if (!boxA.intersects(boxB))
+                {
+                    continue;
+                }
+                if (key(cellOf(max(boxA.minX, boxB.minX)), cellOf(max(boxA.minY, boxB.minY))) != cell.first)
+                {
+                    continue;
+                }
+                VertexView<int, float> shapeA = this->plots[members[a]]->getShape()->getVertexView();
+                VertexView<int, float> shapeB = this->plots[members[b]]->getShape()->getVertexView();
+                if (polygonsOverlap(shapeA.data(), shapeA.size(), shapeB.data(), shapeB.size()))
+                {
+                    int numberA = this->plots[members[a]]->getNumber();
+                    int numberB = this->plots[members[b]]->getNumber();
+                    overlaps.push_back(make_pair(min(numberA, numberB), max(numberA, numberB)));
+                }
+            }
+        }
+    }
+    sort(overlaps.begin(), overlaps.end());
+    return overlaps;
+}
+
+/**
+ * @brief Group the plots by owner
+ * 
+ */
+void Map::indexOwners()
+{
+    this->ownerIndex.clear();
+    for (auto plot : this->plots)
+    {
+        this->ownerIndex[plot->getOwnerId()].push_back(plot);
+    }
+}
+
+/**
+ * @brief Get all the plots of an owner, in O(1)
+ * 
+ * @param owner 
+ * @return const vector<Plot*>& empty if the owner has no plot
+ */
+const vector<Plot*>& Map::getPlotsOf(const string& owner) const
+{
+    static const vector<Plot*> none;
+    uint32_t id;
+    if (!StringPool::getInstance().find(owner, id))
+    {
+        return none;
+    }
+    auto it = this->ownerIndex.find(id);
+    return it == this->ownerIndex.end() ? none : it->second;
+}
+
+/**
+ * @brief Index the plots by number
+ * 
+ */
+void Map::indexNumbers()
+{
+    this->numbers.clear();
+    this->numbers.reserve(this->plots.size());
+    for (size_t i = 0; i < this->plots.size(); i++)
+    {
+        this->numbers.emplace(this->plots[i]->getNumber(), i);
+    }
+}
+
+/**
+ * @brief Find a plot by number, in O(1)
+ * 
+ * @param number 
+ * @return Plot* nullptr if there is no such plot
+ */
+Plot* Map::findPlot(int number) const
+{
+    auto it = this->numbers.find(number);
+    return it == this->numbers.end() ? nullptr : this->plots[it->second];
+}
+
+/**
+ * @brief Find a plot by number. Throws an exception if there is no such plot
+ * 
+ */
+Plot* Map::getPlot(int number) const
+{
+    Plot* plot = findPlot(number);
+    if (!plot)
+    {
+        throw runtime_error("No plot number " + to_string(number));
+    }
+    return plot;
+}
+
+/**
+ * @brief Take a changed plot out of the spatial index until it is rebuilt. The index is rebuilt once the plots to test one by one get too many
+ * 
+ */
+void Map::markEdited(Plot* plot)
+{
+    if (this->staleEntries.insert(plot).second)
+    {
+        this->editedPlots.push_back(plot);
+    }
+    if (this->editedPlots.size() > max<size_t>(1024, this->plots.size() / 16))
+    {
+        buildIndex();
+    }
+}
+
+/**
+ * @brief Apply a change to a plot of the map, keeping the indexes up to date. Throws an exception, and changes nothing, if the change is not possible
+ * 
+ */
+void Map::apply(const JournalEntry& entry, Plot* plot)
+{
+    switch (entry.operation)
+    {
+        case SET_OWNER:
+        {
+            auto it = this->ownerIndex.find(plot->getOwnerId());
+            if (it != this->ownerIndex.end())
+            {
+                it->second.erase(remove(it->second.begin(), it->second.end(), plot), it->second.end());
+                if (it->second.empty())
+                {
+                    this->ownerIndex.erase(it);
+                }
+            }
+            plot->setOwner(entry.owner);
+            this->ownerIndex[plot->getOwnerId()].push_back(plot);
+            break;
+        }
+        case SET_SHAPE:
+            plot->getShape()->setVertices(entry.vertices);
+            markEdited(plot);
+            break;
+        case SET_BUILT_AREA:
+            if (plot->getType() != PlotType::URBAN_ZONE)
+            {
+                throw runtime_error("Plot " + to_string(entry.number) + " is not an urban zone");
+            }
+            dynamic_cast<UrbanZone*>(plot)->setBuiltArea(entry.builtArea);
+            break;
+        case SET_TYPE:
+        {
+            // a plot cannot change class: a new plot of the new type takes its place, with the same shape
+            string type = PlotTypeToString(entry.type);
+            PlotRecord record;
+            record.type = type;
+            record.number = plot->getNumber();
+            record.owner = plot->getOwner();
+            record.pBuildable = plot->getPBuildable();
+            record.builtArea = entry.builtArea;
+            record.cropType = entry.cropType;
+            Plot* replacement = createPlot(record, plot->getShape(), &this->arena);
+            this->plots[this->numbers[entry.number]] = replacement;
+            vector<Plot*>& owned = this->ownerIndex[plot->getOwnerId()];
+            replace(owned.begin(), owned.end(), plot, replacement);
+            if (!this->staleEntries.insert(plot).second)
+            {
+                this->editedPlots.erase(remove(this->editedPlots.begin(), this->editedPlots.end(), plot), this->editedPlots.end());
+            }
+            markEdited(replacement);
+            break;
+        }
+    }
+}
+
+/**
+ * @brief Check that a string can be written as one token of the text format and of the journal: not empty, without blanks nor line breaks
+ * 
+ * @param s 
+ * @return bool 
+ */
+static bool isToken(const string& s)
+{
+    return !s.empty() && s.find_first_of(" \t\r\n\v\f") == string::npos;
+}
+
+/**
+ * @brief Apply a change, then append it to the journal if the map has one, and start a compaction once the journal is long enough.
+ * Throws an exception, before changing anything, if an owner or crop type could not be read back from the journal
+ * 
+ */
+void Map::record(const JournalEntry& entry, Plot* plot)
+{
+    if (entry.operation == SET_OWNER && !isToken(entry.owner))
+    {
+        throw runtime_error("Invalid owner \"" + entry.owner + "\": it must be one word");
+    }
+    if (entry.operation == SET_TYPE && entry.type == PlotType::AGRICULTURAL_ZONE && !isToken(entry.cropType))
+    {
+        throw runtime_error("Invalid crop type \"" + entry.cropType + "\": it must be one word");
+    }
+    apply(entry, plot);
+    if (this->journal.isOpen())
+    {
+        this->journal.append(entry);
+        if (this->compactionThreshold > 0 && this->journal.getEntryCount() >= this->compactionThreshold)
+        {
+            compact();
+        }
+    }
+}
+
+/**
+ * @brief Change the owner of a plot of the map, moving it in the owner index
+ * 
+ * @param plot 
+ * @param owner 
+ */
+void Map::setPlotOwner(Plot* plot, const string& owner)
+{
+    JournalEntry entry;
+    entry.operation = SET_OWNER;
+    entry.number = plot->getNumber();
+    entry.owner = owner;
+    record(entry, plot);
+}
+
+/**
+ * @brief Change the owner of a plot of the map, found by number. Throws an exception if there is no such plot
+ * 
+ * @param number 
+ * @param owner 
+ */
+void Map::setPlotOwner(int number, const string& owner)
+{
+    setPlotOwner(getPlot(number), owner);
+}
+
+/**
+ * @brief Replace the shape of a plot. Throws an exception, and changes nothing, if there is no such plot or the new shape intersects itself
+ * 
+ * @param number 
+ * @param vertices 
+ */
+void Map::reshapePlot(int number, const vector<Point2D<int, float>>& vertices)
+{
+    JournalEntry entry;
+    entry.operation = SET_SHAPE;
+    entry.number = number;
+    entry.vertices = vertices;
+    record(entry, getPlot(number));
+}
+
+/**
+ * @brief Change the type of a plot, e.g. a zone to be urbanized becoming an urban zone. The number, owner, shape and percentage of buildable area are kept.
+ * Throws an exception if there is no such plot, or if the new type is an agricultural zone, which needs a crop type: see the other reclassifyPlot()
+ * 
+ * @param number 
+ * @param type 
+ * @param builtArea for an urban zone, kept as is even if 0
+ */
+void Map::reclassifyPlot(int number, PlotType type, float builtArea)
+{
+    if (type == PlotType::AGRICULTURAL_ZONE)
+    {
+        throw logic_error("An agricultural zone needs a crop type");
+    }
+    JournalEntry entry;
+    entry.operation = SET_TYPE;
+    entry.number = number;
+    entry.type = type;
+    entry.builtArea = builtArea;
+    record(entry, getPlot(number));
+}
+
+/**
+ * @brief Change a plot into an agricultural zone. The number, owner and shape are kept. Throws an exception if there is no such plot or the crop type is empty or has blanks
+ * 
+ * @param number 
+ * @param cropType one word
+ */
+void Map::reclassifyPlot(int number, const string& cropType)
+{
+    JournalEntry entry;
+    entry.operation = SET_TYPE;
+    entry.number = number;
+    entry.type = PlotType::AGRICULTURAL_ZONE;
+    entry.cropType = cropType;
+    record(entry, getPlot(number));
+}
+
+/**
+ * @brief Change the built area of an urban zone. Throws an exception if there is no such plot or it is not an urban zone
+ * 
+ * @param number 
+ * @param builtArea in square meters
+ */
+void Map::setPlotBuiltArea(int number, float builtArea)
+{
+    JournalEntry entry;
+    entry.operation = SET_BUILT_AREA;
+    entry.number = number;
+    entry.builtArea = builtArea;
+    record(entry, getPlot(number));
+}
+
+/**
+ * @brief Get the journal of the changes, open if the map was opened with open()
+ * 
+ * @return const Journal& 
+ */
+const Journal& Map::getJournal() const
+{
+    return this->journal;
+}
+
+/**
+ * @brief Set the number of changes in the journal that starts a compaction
+ * 
+ * @param entryCount 0 to compact only when compact() is called
+ */
+void Map::setCompactionThreshold(size_t entryCount)
+{
+    this->compactionThreshold = entryCount;
+}
+
+/**
+ * @brief Start folding the journal into a new snapshot file, in the background. The changes journaled so far are moved to a separate file, and the next changes go to a new empty journal, so the map can still be changed meanwhile.
+ * A background thread loads the snapshot, replays the moved changes and writes the result to a temporary file, which then replaces the snapshot. If it fails, the moved changes are kept and folded by the next compaction
+ * 
+ * @return bool false if the map has no journal or a compaction is already running
+ */
+bool Map::compact()
+{
+    if (!this->journal.isOpen() || isCompacting())
+    {
+        return false;
+    }
+    waitForCompaction();
+    string segment = segmentOf(this->journal.getFilename());
+    if (access(segment.c_str(), F_OK) != 0) // else the changes of a failed compaction are folded first; the journal waits for the next one
+    {
+        this->journal.rotate(segment);
+    }
+    this->compaction = async(launch::async, fold, this->snapshotFile, segment);
+    return true;
+}
+
+/**
+ * @brief Check if a compaction is running
+ * 
+ * @return bool 
+ */
+bool Map::isCompacting() const
+{
+    return this->compaction.valid() && this->compaction.wait_for(chrono::seconds(0)) != future_status::ready;
+}
+
+/**
+ * @brief Wait for the running compaction, if any, to be over
+ * 
+ * @return bool false if it failed
+ */
+bool Map::waitForCompaction()
+{
+    return this->compaction.valid() ? this->compaction.get() : true;
+}
+
+/**
+ * @brief Replay the changes of a segment of the journal on a snapshot file, then replace the snapshot by the result and delete the segment.
+ * The new snapshot is written to a temporary file and flushed before it replaces the old one: after a crash, either the old snapshot and the segment are left, or the new snapshot. Replaying the segment again on the new snapshot changes nothing
+ * 
+ */
+bool Map::fold(const string& snapshotFile, const string& segment)
+{
+    try
+    {
+        Map folded(snapshotFile);
+        folded.replay(segment);
+        string temporary = snapshotFile + ".tmp";
+        int fd = ::open(temporary.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0)
+        {
+            return false;
+        }
+        bool written = writePlotsText(folded.getPlots(), fd) && fsync(fd) == 0;
+        if (close(fd) != 0 || !written || rename(temporary.c_str(), snapshotFile.c_str()) != 0)
+        {
+            remove(temporary.c_str());
+            return false;
+        }
+        return unlink(segment.c_str()) == 0;
+    }
+    catch (const exception&)
+    {
+        return false;
+    }
+}
+
+/**
+ * @brief Get the memory used by the owners and crop types of the plots: their numbers, and the strings of the pool they refer to, each counted once.
+ * The pool is shared with the other maps, so only the strings used by this map are counted, and an empty map uses none
+ * 
+ * @return size_t in bytes
+ */
+size_t Map::getStringMemory() const
+{
+    const StringPool& pool = StringPool::getInstance();
+    unordered_set<uint32_t> used;
+    size_t total = 0;
+    auto count = [&](uint32_t id) {
+        total += sizeof(uint32_t); // kept by the plot
+        if (used.insert(id).second)
+        {
+            total += pool.getMemoryUsage(id);
+        }
+    };
+    for (auto plot : this->plots)
+    {
+        count(plot->getOwnerId());
+        if (plot->getType() == PlotType::AGRICULTURAL_ZONE)
+        {
+            count(dynamic_cast<const AgriculturalZone*>(plot)->getCropTypeId());
+        }
+    }
+    return total;
+}
+
+/**
+ * @brief Get the memory the owners and crop types would use if every plot had its own copy of the strings
+ * 
+ * @return size_t in bytes
+ */
+size_t Map::getUninternedStringMemory() const
+{
+    auto stringSize = [](const string& s) { return sizeof(string) + (s.size() > 15 ? s.size() + 1 : 0); };
+    size_t total = 0;
+    for (auto plot : this->plots)
+    {
+        total += stringSize(plot->getOwner());
+        if (plot->getType() == PlotType::AGRICULTURAL_ZONE)
+        {
+            total += stringSize(dynamic_cast<AgriculturalZone*>(plot)->getCropType());
+        }
+    }
+    return total;
+}
+
+/**
+ * @brief Overload of the << operator for printing a map
+ * 
+ * @param os 
+ * @param m 
+ * @return ostream& 
+ */
+ostream& operator<<(ostream& os, const Map& m)
+{
+    os << "Map: " << m.getPlotCount() << " plots" << endl;
+    os << "\tTotal area: " << m.getTotalArea() << " m2" << endl;
+    os << "\tOwners: " << m.ownerIndex.size() << ", strings: " << m.getStringMemory() << " bytes interned (" << m.getUninternedStringMemory() << " bytes as separate strings)" << endl;
+    os << "\tInvalid plots: " << m.report.invalidPlotCount << endl;
+    os << "\tMemory: " << m.getMemoryFootprint() << " bytes (" << m.arena.getBytesUsed() << " used in " << m.arena.getBlockCount() << " blocks, " << m.arena.getObjectCount() << " objects)" << endl;
+    return os;
+}
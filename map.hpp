@@ -0,0 +1,129 @@
+/**
+ * @file map.hpp
+ * @author Bastien, Victor, AlexisR 
+ * @brief Header file for the Map class
+ * @version 0.1
+ * @date 2024-01-16
+ * 
+ * @copyright Copyright (c) 2024
+ * 
+ */
+
+#include <future>
+#include <iostream>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include "plot.hpp"
+#include "arena.hpp"
+#include "journal.hpp"
+#include "rtree.hpp"
+#include "validation.hpp"
+
+#ifndef MAP_HPP
+#define MAP_HPP
+
+using namespace std;
+
+/**
+ * @brief The AreaTotals struct holds the totals of a group of plots. The areas are summed in fixed point, so that the totals are exact and do not depend on the order of the plots nor on how they were split between threads
+ * 
+ */
+struct AreaTotals
+{
+    size_t plotCount = 0;
+    Shoelace<int, float>::Accumulator twiceArea = 0; // sum of the exact shoelace sums of the shapes, see Polygon::getTwiceArea()
+    Shoelace<int, float>::Accumulator buildableArea = 0; // sum of the buildable areas, in 2^-FixedPoint<float>::FRACTION_BITS square meters
+    void add(const Plot& plot);
+    void merge(const AreaTotals& t);
+    double getArea() const;
+    double getBuildableArea() const;
+};
+
+/**
+ * @brief The MapAggregates struct holds the totals of a map, overall, by type of plot and by owner
+ * 
+ */
+struct MapAggregates
+{
+    AreaTotals total;
+    AreaTotals byType[4]; // indexed by PlotType
+    unordered_map<uint32_t, AreaTotals> byOwner; // owner number in the string pool -> totals
+    void merge(const MapAggregates& a);
+    const AreaTotals& getOwnerTotals(const string& owner) const;
+};
+
+MapAggregates aggregatePlots(const Plot* const* plots, size_t count, unsigned threadCount = 0);
+
+/**
+ * @brief The Map class is a list of plots loaded from a file. The plots, their shapes and their vertices all live in an arena owned by the map, and are released together.
+ * An R-tree over the bounding boxes of the plots answers spatial queries. It is built on load; the plots changed through the map are tested one by one until it is rebuilt, call buildIndex() again after changing the shapes of the plots directly.
+ * The plots are also indexed by owner and by number. Change owners through setPlotOwner() to keep the index up to date. Every plot is validated on load, see getValidationReport().
+ * A map opened with open() saves its changes in a journal instead of rewriting its file: each change is appended to the journal, and replayed on the snapshot file when the map is opened again.
+ * Once the journal is long enough, it is folded into a new snapshot file by a background thread, see compact(). The old versions of the changed plots stay in the arena until the map is loaded again
+ * 
+ */
+class Map
+{
+    private:
+        Arena arena;
+        vector<Plot*> plots;
+        RTree<Plot*> index;
+        unordered_map<uint32_t, vector<Plot*>> ownerIndex; // owner number in the string pool -> plots
+        unordered_map<int, size_t> numbers; // plot number -> position of its first plot
+        unordered_set<const Plot*> staleEntries; // plots whose entry in the spatial index is out of date, skipped by the queries
+        vector<Plot*> editedPlots; // plots changed since the index was built, tested one by one by the queries
+        ValidationReport report; // of the last load
+        Journal journal;
+        string snapshotFile; // the file the journal applies to
+        size_t compactionThreshold;
+        future<bool> compaction;
+        void indexOwners();
+        void indexNumbers();
+        Plot* getPlot(int number) const;
+        void markEdited(Plot* plot);
+        void apply(const JournalEntry& entry, Plot* plot);
+        void record(const JournalEntry& entry, Plot* plot);
+        void replay(const string& journalFile);
+        static bool fold(const string& snapshotFile, const string& segment);
+    public:
+        Map();
+        Map(const string& filename);
+        Map(const Map& m) = delete;
+        Map& operator=(const Map& m) = delete;
+        ~Map();
+        void load(const string& filename);
+        void open(const string& snapshotFile, const string& journalFile, bool sync = false);
+        void clear();
+        const vector<Plot*>& getPlots() const;
+        size_t getPlotCount() const;
+        float getTotalArea() const;
+        MapAggregates aggregate(unsigned threadCount = 0) const;
+        ValidationReport validate(unsigned threadCount = 0) const;
+        const ValidationReport& getValidationReport() const;
+        size_t getMemoryFootprint() const;
+        const Arena& getArena() const;
+        void buildIndex();
+        Plot* findPlotAt(double x, double y) const;
+        vector<Plot*> findPlotsIn(const BoundingBox& box) const;
+        vector<pair<int, int>> findOverlaps() const;
+        const vector<Plot*>& getPlotsOf(const string& owner) const;
+        Plot* findPlot(int number) const;
+        void setPlotOwner(Plot* plot, const string& owner);
+        void setPlotOwner(int number, const string& owner);
+        void reshapePlot(int number, const vector<Point2D<int, float>>& vertices);
+        void reclassifyPlot(int number, PlotType type, float builtArea = 0);
+        void reclassifyPlot(int number, const string& cropType);
+        void setPlotBuiltArea(int number, float builtArea);
+        const Journal& getJournal() const;
+        void setCompactionThreshold(size_t entryCount);
+        bool compact();
+        bool isCompacting() const;
+        bool waitForCompaction();
+        size_t getStringMemory() const;
+        size_t getUninternedStringMemory() const;
+
+        friend ostream& operator<<(ostream& os, const Map& m);
+};
+
+#endif // MAP_HPP
@@ -0,0 +1,446 @@
+/**
+ * @file parser.cpp
+ * @author Bastien, Victor, AlexisR 
+ * @brief Implementation file for the memory-mapped cadastre parser. The file is never copied: fields are tokenized in place and numbers are read with from_chars, without streams nor temporary strings
+ * @version 0.1
+ * @date 2024-01-16
+ * 
+ * @copyright Copyright (c) 2024
+ * 
+ */
+
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <thread>
+#include "parser.hpp"
+
+using namespace std;
+
+/**
+ * @brief Construct a new MappedFile::MappedFile object by mapping the file
+ * 
+ * @param filename 
+ */
+MappedFile::MappedFile(const string& filename)
+{
+    this->data = nullptr;
+    this->size = 0;
+    this->open = false;
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        return;
+    }
+    struct stat info;
+    if (fstat(fd, &info) == 0)
+    {
+        this->open = true;
+        this->size = static_cast<size_t>(info.st_size);
+        if (this->size > 0)
+        {
+            void* mapping = mmap(nullptr, this->size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapping == MAP_FAILED)
+            {
+                this->open = false;
+                this->size = 0;
+            }
+            else
+            {
+                madvise(mapping, this->size, MADV_SEQUENTIAL);
+                this->data = static_cast<const char*>(mapping);
+            }
+        }
+    }
+    ::close(fd); // the mapping stays valid after closing the descriptor
+}
+
+/**
+ * @brief Destroy the MappedFile::MappedFile object and unmap the file
+ * 
+ */
+MappedFile::~MappedFile()
+{
+    if (this->data)
+    {
+        munmap(const_cast<char*>(this->data), this->size);
+    }
+}
+
+/**
+ * @brief Check if the file could be opened and mapped
+ * 
+ * @return bool 
+ */
+bool MappedFile::isOpen() const
+{
+    return this->open;
+}
+
+/**
+ * @brief Get the first byte of the file
+ * 
+ * @return const char* 
+ */
+const char* MappedFile::begin() const
+{
+    return this->data;
+}
+
+/**
+ * @brief Get the byte past the end of the file
+ * 
+ * @return const char* 
+ */
+const char* MappedFile::end() const
+{
+    return this->data + this->size;
+}
+
+/**
+ * @brief Get the size of the file in bytes
+ * 
+ * @return size_t 
+ */
+size_t MappedFile::getSize() const
+{
+    return this->size;
+}
+
+/**
+ * @brief Whitespace inside a line (the files can have \r\n line endings)
+ * 
+ */
+static bool isBlank(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+}
+
+/**
+ * @brief Get the next whitespace-separated token of a line and move p after it. Returns an empty view at the end of the line
+ * 
+ */
+static string_view nextToken(const char*& p, const char* end)
+{
+    while (p < end && isBlank(*p))
+    {
+        p++;
+    }
+    const char* start = p;
+    while (p < end && !isBlank(*p))
+    {
+        p++;
+    }
+    return string_view(start, p - start);
+}
+
+/**
+ * @brief Read a number token, leaving value untouched if the token is missing or is not a number
+ * 
+ */
+template <typename N>
+static void readNumber(const char*& p, const char* end, N& value)
+{
+    string_view token = nextToken(p, end);
+    from_chars(token.data(), token.data() + token.size(), value);
+}
+
+/**
+ * @brief Get the end of the line starting at p (the position of '\n' or end)
+ * 
+ */
+static const char* lineEnd(const char* p, const char* end)
+{
+    const void* newline = memchr(p, '\n', end - p);
+    return newline ? static_cast<const char*>(newline) : end;
+}
+
+/**
+ * @brief Construct a new RecordScanner::RecordScanner object
+ * 
+ * @param begin 
+ * @param end 
+ */
+RecordScanner::RecordScanner(const char* begin, const char* end)
+{
+    this->cursor = begin;
+    this->end = end;
+}
+
+/**
+ * @brief Read the next record. Blank lines between records are skipped
+ * 
+ * @param record 
+ * @return bool false when the end of the buffer is reached
+ */
+bool RecordScanner::next(PlotRecord& record)
+{
+    const char* header;
+    const char* headerEnd;
+    do
+    {
+        if (this->cursor >= this->end)
+        {
+            return false;
+        }
+        header = this->cursor;
+        headerEnd = lineEnd(header, this->end);
+        this->cursor = headerEnd < this->end ? headerEnd + 1 : headerEnd;
+        const char* p = header;
+        record.type = nextToken(p, headerEnd);
+    } while (record.type.empty());
+
+    const char* p = header;
+    nextToken(p, headerEnd); // type, already read
+    record.number = 0;
+    readNumber(p, headerEnd, record.number);
+    record.owner = nextToken(p, headerEnd);
+    record.pBuildable = 0;
+    record.builtArea = 0;
+    record.cropType = string_view();
+    if (record.type == "ZU")
+    {
+        readNumber(p, headerEnd, record.pBuildable);
+        readNumber(p, headerEnd, record.builtArea);
+    }
+    else if (record.type == "ZAU")
+    {
+        readNumber(p, headerEnd, record.pBuildable);
+    }
+    else if (record.type == "ZA")
+    {
+        record.cropType = nextToken(p, headerEnd);
+    }
+
+    record.verticesBegin = this->cursor;
+    record.verticesEnd = lineEnd(this->cursor, this->end);
+    this->cursor = record.verticesEnd < this->end ? record.verticesEnd + 1 : record.verticesEnd;
+    return true;
+}
+
+/**
+ * @brief Get the position of the next record in the buffer
+ * 
+ * @return const char* 
+ */
+const char* RecordScanner::getPosition() const
+{
+    return this->cursor;
+}
+
+/**
+ * @brief Parse the "[x;y]" pairs of [begin, end) into a vector, reserved first to the number of '[' so that it is allocated once
+ * 
+ */
+template <typename Vector>
+static void parseVerticesInto(const char* begin, const char* end, Vector& vertices)
+{
+    vertices.reserve(vertices.size() + count(begin, end, '['));
+    const char* p = begin;
+    while (true)
+    {
+        p = static_cast<const char*>(memchr(p, '[', end - p));
+        if (!p)
+        {
+            return;
+        }
+        int x = 0;
+        float y = 0;
+        from_chars_result rx = from_chars(p + 1, end, x);
+        if (rx.ec != errc() || rx.ptr >= end || *rx.ptr != ';')
+        {
+            p = rx.ptr; // malformed pair, look for the next one
+            continue;
+        }
+        from_chars_result ry = from_chars(rx.ptr + 1, end, y);
+        if (ry.ec != errc())
+        {
+            p = ry.ptr;
+            continue;
+        }
+        vertices.emplace_back(x, y);
+        p = ry.ptr;
+    }
+}
+
+void parseVertices(const char* begin, const char* end, vector<Point2D<int, float>>& vertices)
+{
+    parseVerticesInto(begin, end, vertices);
+}
+
+void parseVertices(const char* begin, const char* end, pmr::vector<Point2D<int, float>>& vertices)
+{
+    parseVerticesInto(begin, end, vertices);
+}
+
+/**
+ * @brief Create an object with new, or in the arena if there is one
+ * 
+ */
+template <typename C, typename... Args>
+static C* make(Arena* arena, Args&&... args)
+{
+    if (arena)
+    {
+        return arena->create<C>(forward<Args>(args)...);
+    }
+    return new C(forward<Args>(args)...);
+}
+
+Plot* createPlot(const PlotRecord& record, Polygon<int, float>* shape, Arena* arena)
+{
+    if (record.type == "ZU")
+    {
+        return make<UrbanZone>(arena, record.number, record.owner, shape, record.pBuildable, record.builtArea, false);
+    }
+    else if (record.type == "ZAU")
+    {
+        return make<ZoneToBeUrbanized>(arena, record.number, record.owner, shape, record.pBuildable);
+    }
+    else if (record.type == "ZN")
+    {
+        return make<NaturalAndForestZone>(arena, record.number, record.owner, shape);
+    }
+    else if (record.type == "ZA")
+    {
+        return make<AgriculturalZone>(arena, record.number, record.owner, shape, record.cropType);
+    }
+    return nullptr;
+}
+
+/**
+ * @brief Create the plots of all the records in [begin, end)
+ * 
+ */
+static void loadRecords(const char* begin, const char* end, vector<Plot*>& plots, Arena* arena)
+{
+    RecordScanner scanner(begin, end);
+    PlotRecord record;
+    pmr::memory_resource* resource = arena ? arena : STATS_RESOURCE();
+    while (scanner.next(record))
+    {
+        // parsed straight into the storage of the polygon, which takes the vector over without copying it
+        pmr::vector<Point2D<int, float>> vertices(resource);
+        parseVertices(record.verticesBegin, record.verticesEnd, vertices);
+        // kept even if it intersects itself: the plots are checked by validatePlots(), which reports what is wrong instead of printing it
+        Polygon<int, float>* shape;
+        if (arena)
+        {
+            shape = arena->create<Polygon<int, float>>(move(vertices), false);
+        }
+        else
+        {
+            shape = new Polygon<int, float>(move(vertices), false);
+        }
+        Plot* plot = createPlot(record, shape, arena);
+        if (plot)
+        {
+            plots.push_back(plot);
+        }
+        else if (!arena)
+        {
+            delete shape;
+        }
+    }
+}
+
+/**
+ * @brief Check if the line starting at p is the first line of a record: the second line of a record always starts with a '['
+ * 
+ */
+static bool isHeaderLine(const char* p, const char* end)
+{
+    while (p < end && isBlank(*p))
+    {
+        p++;
+    }
+    return p < end && *p != '[' && *p != '\n';
+}
+
+/**
+ * @brief Get the first record boundary at or after p
+ * 
+ */
+static const char* nextRecordStart(const char* p, const char* begin, const char* end)
+{
+    if (p > begin && p[-1] != '\n') // move to the start of the next line
+    {
+        p = lineEnd(p, end);
+        p = p < end ? p + 1 : p;
+    }
+    while (p < end && !isHeaderLine(p, end))
+    {
+        p = lineEnd(p, end);
+        p = p < end ? p + 1 : p;
+    }
+    return p;
+}
+
+vector<Plot*> loadPlots(const string& filename, Arena* arena)
+{
+    STATS_TIME(LOAD_TEXT);
+    vector<Plot*> plots;
+    MappedFile file(filename);
+    if (!file.isOpen())
+    {
+        cout << "Unable to open file" << endl;
+        return plots;
+    }
+    loadRecords(file.begin(), file.end(), plots, arena);
+    return plots;
+}
+
+vector<Plot*> loadPlotsParallel(const string& filename, unsigned threadCount)
+{
+    STATS_TIME(LOAD_TEXT);
+    vector<Plot*> plots;
+    MappedFile file(filename);
+    if (!file.isOpen())
+    {
+        cout << "Unable to open file" << endl;
+        return plots;
+    }
+    if (threadCount == 0)
+    {
+        threadCount = max(1u, thread::hardware_concurrency());
+    }
+    const size_t minChunkSize = 1 << 16; // below this, starting a thread costs more than parsing
+    threadCount = static_cast<unsigned>(min<size_t>(threadCount, file.getSize() / minChunkSize + 1));
+
+    vector<const char*> bounds(threadCount + 1);
+    bounds[0] = file.begin();
+    bounds[threadCount] = file.end();
+    for (unsigned i = 1; i < threadCount; i++)
+    {
+        const char* tentative = file.begin() + file.getSize() / threadCount * i;
+        bounds[i] = nextRecordStart(max(tentative, bounds[i-1]), file.begin(), file.end());
+    }
+
+    vector<vector<Plot*>> chunks(threadCount);
+    vector<thread> workers;
+    for (unsigned i = 1; i < threadCount; i++)
+    {
+        workers.emplace_back(loadRecords, bounds[i], bounds[i+1], ref(chunks[i]), nullptr);
+    }
+    loadRecords(bounds[0], bounds[1], chunks[0], nullptr);
+    for (auto& worker : workers)
+    {
+        worker.join();
+    }
+
+    size_t count = 0;
+    for (const auto& chunk : chunks)
+    {
+        count += chunk.size();
+    }
+    plots.reserve(count);
+    for (const auto& chunk : chunks)
+    {
+        plots.insert(plots.end(), chunk.begin(), chunk.end());
+    }
+    return plots;
+}
@@ -0,0 +1,113 @@
+/**
+ * @file parser.hpp
+ * @author Bastien, Victor, AlexisR 
+ * @brief Header file for the memory-mapped cadastre parser
+ * @version 0.1
+ * @date 2024-01-16
+ * 
+ * @copyright Copyright (c) 2024
+ * 
+ */
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include "plot.hpp"
+#include "arena.hpp"
+
+#ifndef PARSER_HPP
+#define PARSER_HPP
+
+using namespace std;
+
+/**
+ * @brief The MappedFile class maps a whole file in memory, read only. The mapping is released when the object is destroyed
+ * 
+ */
+class MappedFile
+{
+    private:
+        const char* data;
+        size_t size;
+        bool open;
+    public:
+        MappedFile(const string& filename);
+        MappedFile(const MappedFile& m) = delete;
+        MappedFile& operator=(const MappedFile& m) = delete;
+        ~MappedFile();
+        bool isOpen() const;
+        const char* begin() const;
+        const char* end() const;
+        size_t getSize() const;
+};
+
+/**
+ * @brief The PlotRecord struct is the content of the two lines describing a plot. The strings and the vertices point into the parsed buffer, nothing is copied
+ * 
+ */
+struct PlotRecord
+{
+    string_view type; // ZU, ZAU, ZA or ZN
+    int number = 0;
+    string_view owner;
+    int pBuildable = 0; // ZU and ZAU only
+    float builtArea = 0; // ZU only
+    string_view cropType; // ZA only
+    const char* verticesBegin = nullptr; // second line of the record, "[x;y] [x;y] ..."
+    const char* verticesEnd = nullptr;
+};
+
+/**
+ * @brief The RecordScanner class walks a buffer in the text format record by record, tokenizing in place
+ * 
+ */
+class RecordScanner
+{
+    private:
+        const char* cursor;
+        const char* end;
+    public:
+        RecordScanner(const char* begin, const char* end);
+        bool next(PlotRecord& record);
+        const char* getPosition() const;
+};
+
+/**
+ * @brief Parse a line of "[x;y]" pairs and append the points to vertices
+ * 
+ * @param begin 
+ * @param end 
+ * @param vertices 
+ */
+void parseVertices(const char* begin, const char* end, vector<Point2D<int, float>>& vertices);
+void parseVertices(const char* begin, const char* end, pmr::vector<Point2D<int, float>>& vertices);
+
+/**
+ * @brief Create the plot described by a record, of the class matching its type. Returns nullptr if the type is unknown
+ * 
+ * @param record 
+ * @param shape 
+ * @param arena if given, the plot is created in the arena instead of with new
+ * @return Plot* 
+ */
+Plot* createPlot(const PlotRecord& record, Polygon<int, float>* shape, Arena* arena = nullptr);
+
+/**
+ * @brief Load all the plots of a file in the text format
+ * 
+ * @param filename 
+ * @param arena if given, the plots, their shapes and their vertices are allocated in the arena, which owns them
+ * @return vector<Plot*> 
+ */
+vector<Plot*> loadPlots(const string& filename, Arena* arena = nullptr);
+
+/**
+ * @brief Load all the plots of a file in the text format on several threads. The file is split in chunks starting on a record boundary, each chunk is parsed by one thread and the plots are merged back in file order, so the result is the same as loadPlots()
+ * 
+ * @param filename 
+ * @param threadCount 0 to use one thread per core
+ * @return vector<Plot*> 
+ */
+vector<Plot*> loadPlotsParallel(const string& filename, unsigned threadCount = 0);
+
+#endif // PARSER_HPP
@@ -16,8 +16,7 @@
 
 using namespace std;
 
-random_device rd;
-mt19937 gen(rd());
+thread_local mt19937 gen(random_device{}()); // one generator per thread, plots can be created by the parallel loader
 
 string PlotTypeToString(PlotType type) {
     switch(type) {
@@ -29,39 +28,101 @@ string PlotTypeToString(PlotType type) {
     }
 }
 
+/**
+ * @brief Construct a new PlotShape::PlotShape object for a polygon the plot does not own
+ * 
+ * @param polygon 
+ */
+PlotShape::PlotShape(Polygon<int,float>* polygon)
+{
+    this->polygon = polygon;
+}
+
+/**
+ * @brief Construct a new PlotShape::PlotShape object for a polygon the plot will own
+ * 
+ * @param polygon 
+ */
+PlotShape::PlotShape(unique_ptr<Polygon<int,float>> polygon)
+{
+    this->polygon = polygon.get();
+    this->owned = move(polygon);
+}
+
+/**
+ * @brief Construct a new PlotShape::PlotShape object for a polygon the plot will own, moved in without copying its vertices
+ * 
+ * @param polygon 
+ */
+PlotShape::PlotShape(Polygon<int,float>&& polygon)
+{
+    this->owned = make_unique<Polygon<int,float>>(move(polygon));
+    this->polygon = this->owned.get();
+}
+
+/**
+ * @brief Get the polygon
+ * 
+ * @return Polygon<int,float>* 
+ */
+Polygon<int,float>* PlotShape::get() const
+{
+    return this->polygon;
+}
+
+/**
+ * @brief Give away the ownership of the polygon, if it is owned
+ * 
+ * @return unique_ptr<Polygon<int,float>> null if the polygon is not owned
+ */
+unique_ptr<Polygon<int,float>> PlotShape::takeOwnership()
+{
+    return move(this->owned);
+}
+
 /**
  * @brief Construct a new Plot::Plot object
  * 
  * @param number 
  * @param owner 
- * @param shape 
+ * @param shape a pointer to a polygon owned elsewhere, or a polygon that the plot will own
  * @param pBuildable 
  */
-Plot::Plot(int number, string owner, Polygon<int,float>* shape, int pBuildable) 
+Plot::Plot(int number, string_view owner, PlotShape shape, int pBuildable) 
 {
+    STATS_ADD(PLOTS_CONSTRUCTED, 1);
     this->number = number;
-    this->owner = owner;
-    this->shape = shape;
+    this->ownerId = StringPool::getInstance().intern(owner);
+    this->shape = shape.get();
+    this->ownedShape = shape.takeOwnership();
     this->pBuildable = pBuildable;
+    this->area = 0;
     this->calculateArea();
-
-    this->shape->addObserver([this]() { this->calculateArea(); });
 }
 
 /**
- * @brief Construct a new Plot::Plot object by copy
+ * @brief Construct a new Plot::Plot object by copy. A shape owned by p is copied, a shape owned elsewhere is shared
  * 
  * @param p 
  */
 Plot::Plot(const Plot& p)
 {
+    STATS_ADD(PLOTS_COPIED, 1);
     this->number = p.number;
-    this->owner = p.owner;
-    this->shape = p.shape;
+    this->type = p.type;
+    this->ownerId = p.ownerId;
+    if (p.ownedShape)
+    {
+        this->ownedShape = make_unique<Polygon<int,float>>(*p.ownedShape);
+        this->shape = this->ownedShape.get();
+    }
+    else
+    {
+        this->shape = p.shape;
+    }
     this->area = p.area;
+    this->shapeVersion = p.shapeVersion;
     this->pBuildable = p.pBuildable;
-
-    this->shape->addObserver([this]() { this->calculateArea(); }); 
 }
 
 /**
@@ -85,20 +146,34 @@ int Plot::getNumber() const
 /**
  * @brief Get the owner of the plot
  * 
- * @return string 
+ * @return const string& 
+ */
+const string& Plot::getOwner() const
+{
+    return StringPool::getInstance().get(this->ownerId);
+}
+
+/**
+ * @brief Get the number of the owner in the string pool, equal for all the plots of the same owner
+ * 
+ * @return uint32_t 
  */
-string Plot::getOwner() const
+uint32_t Plot::getOwnerId() const
 {
-    return this->owner;
+    return this->ownerId;
 }
 
 /**
- * @brief Get the area of the plot
+ * @brief Get the area of the plot, recomputed first if the shape has changed since the last call
  * 
  * @return float 
  */
 float Plot::getArea() const
 {
+    if (this->shape->getVersion() != this->shapeVersion)
+    {
+        this->calculateArea();
+    }
     return this->area;
 }
 
@@ -127,49 +202,42 @@ void Plot::setNumber(int number)
  * 
  * @param owner 
  */
-void Plot::setOwner(string owner)
+void Plot::setOwner(string_view owner)
 {
-    this->owner = owner;
+    this->ownerId = StringPool::getInstance().intern(owner);
 }
 
 /**
- * @brief Calculate the area of the plot
+ * @brief Calculate the area of the plot from the shoelace sum kept by its shape, and remember which version of the shape it comes from
  * 
  */
-void Plot::calculateArea()
+void Plot::calculateArea() const
 {
-    try{
-        float area = 0;
-        for (int i = 0; i < this->shape->getVertices().size(); i++)
-        {
-            if (i == this->shape->getVertices().size() - 1) //if we are at the last vertex, we need to use the first vertex as the second point
-            {
-                area += (this->shape->getVertices()[i].getX() * this->shape->getVertices()[0].getY()) - (this->shape->getVertices()[i].getY() * this->shape->getVertices()[0].getX());
-            }
-            else
-            {
-                area += (this->shape->getVertices()[i].getX() * this->shape->getVertices()[i+1].getY()) - (this->shape->getVertices()[i].getY() * this->shape->getVertices()[i+1].getX());
-            }
-        }
-        area = area / 2;
-        if (area <= 0) {
-            throw runtime_error("The area of a polygon cannot be negative or null");
-        }
-        this->area = area;
-    }
-    catch (const runtime_error& e) {
-        cout << "Error: " << e.what() << endl;
-    }
+    STATS_ADD(PLOT_AREA_UPDATES, 1);
+    this->shapeVersion = this->shape->getVersion();
+    float area = this->shape->getSignedArea(); // maintained incrementally by the polygon
+    this->area = area > 0 ? area : 0; // a null or clockwise shape is reported by validatePlots()
 }
 
 /**
- * @brief Set the shape of the plot. Also computes the area of the plot and throws an error if the area is negative or null
+ * @brief Get the area that can still be built on. Only the buildable plots (ZU, ZAU and ZA) have one, see Buildable
  * 
- * @param shape 
+ * @return float 0 for the other plots
+ */
+float Plot::getBuildableArea() const
+{
+    return 0;
+}
+
+/**
+ * @brief Set the shape of the plot. Also computes the area of the plot, 0 if it is negative or null
+ * 
+ * @param shape a pointer to a polygon owned elsewhere, or a polygon that the plot will own
  */
-void Plot::setShape(Polygon<int,float>* shape)
+void Plot::setShape(PlotShape shape)
 {
-    this->shape = shape;
+    this->shape = shape.get();
+    this->ownedShape = shape.takeOwnership();
     this->calculateArea();
 }
 
@@ -214,8 +282,8 @@ ostream& operator<<(ostream& os, const Plot& p)
 {
     os << "Plot number: " << p.number << endl;
     os << "\t" << *(p.shape) << endl;
-    os << "\tOwner: " << p.owner << endl;
-    os << "\tArea: " << p.area << " m2" << endl;
+    os << "\tOwner: " << p.getOwner() << endl;
+    os << "\tArea: " << p.getArea() << " m2" << endl;
     return os;
 }
 
@@ -227,7 +295,7 @@ ostream& operator<<(ostream& os, const Plot& p)
  * @param shape 
  * @param pBuildable // default value is 0
  */
-Buildable::Buildable(int number, string owner, Polygon<int,float>* shape, int pBuildable) : Plot(number, owner, shape, pBuildable)
+Buildable::Buildable(int number, string_view owner, PlotShape shape, int pBuildable) : Plot(number, owner, move(shape), pBuildable)
 {
 }
 
@@ -249,17 +317,18 @@ Buildable::~Buildable()
 }
 
 /**
- * @brief Construct a new UrbanZone::UrbanZone object. The built area is randomly generated between 0 and the maximum buildable area
+ * @brief Construct a new UrbanZone::UrbanZone object. If the built area is not specified, it is randomly generated between 0 and the maximum buildable area
  * 
  * @param number 
  * @param owner 
  * @param shape 
  * @param pBuildable 
  * @param builtArea Default value is 0 if not specified 
+ * @param randomIfUnspecified if false, a built area of 0 is kept as is: the loaders and the editors pass false, 0 being a stored value for them
  */
-UrbanZone::UrbanZone(int number, string owner, Polygon<int,float>* shape, int pBuildable, float builtArea) : Plot(number, owner, shape, pBuildable), Buildable(number, owner, shape, pBuildable)
+UrbanZone::UrbanZone(int number, string_view owner, PlotShape shape, int pBuildable, float builtArea, bool randomIfUnspecified) : Plot(number, owner, move(shape), pBuildable), Buildable(number, owner, nullptr, pBuildable)
 {
-    if (!builtArea) { //if builtArea is not specified, we generate a random value between 0 and the maximum buildable area
+    if (!builtArea && randomIfUnspecified) { //if builtArea is not specified, we generate a random value between 0 and the maximum buildable area
         float maxBuiltArea = getArea() * (static_cast<float>(getPBuildable()) / 100.0f);
         uniform_real_distribution<float> dis(0, maxBuiltArea);
         this->builtArea = dis(gen);
@@ -308,6 +377,16 @@ float UrbanZone::getBuiltArea() const
     return this->builtArea;
 }
 
+/**
+ * @brief Set the built area of the plot. Unlike the constructor, 0 is kept as is
+ * 
+ * @param builtArea in square meters
+ */
+void UrbanZone::setBuiltArea(float builtArea)
+{
+    this->builtArea = builtArea;
+}
+
 /**
  * @brief Get the buildable area of the plot
  * 
@@ -347,7 +426,7 @@ ostream& operator<<(ostream& os, const UrbanZone& u)
  * @param shape 
  * @param pBuildable 
  */
-ZoneToBeUrbanized::ZoneToBeUrbanized(int number, string owner, Polygon<int,float>* shape, int pBuildable) : Plot(number, owner, shape, pBuildable), Buildable(number, owner, shape, pBuildable)
+ZoneToBeUrbanized::ZoneToBeUrbanized(int number, string_view owner, PlotShape shape, int pBuildable) : Plot(number, owner, move(shape), pBuildable), Buildable(number, owner, nullptr, pBuildable)
 {
     this->setType(PlotType::ZONE_TO_BE_URBANIZED);
 }
@@ -376,7 +455,7 @@ ZoneToBeUrbanized::~ZoneToBeUrbanized()
  */
 float ZoneToBeUrbanized::getBuildableArea() const
 {
-    float buildableArea = this->getArea() * static_cast<float>(this->getPBuildable() / 100);
+    float buildableArea = this->getArea() * (static_cast<float>(this->getPBuildable()) / 100.0f);
     return buildableArea;
 }
 
@@ -415,7 +494,7 @@ ostream& operator<<(ostream& os, const ZoneToBeUrbanized& z)
  * @param owner 
  * @param shape 
  */
-NaturalAndForestZone::NaturalAndForestZone(int number, string owner, Polygon<int,float>* shape) : Plot(number, owner, shape, 0)
+NaturalAndForestZone::NaturalAndForestZone(int number, string_view owner, PlotShape shape) : Plot(number, owner, move(shape), 0)
 {
     this->setType(PlotType::NATURAL_AND_FOREST_ZONE);
 }
@@ -472,12 +551,13 @@ ostream& operator<<(ostream& os, const NaturalAndForestZone& n)
  * @param shape 
  * @param cropType 
  */
-AgriculturalZone::AgriculturalZone(int number, string owner, Polygon<int,float>* shape, string cropType) : Plot(number, owner, shape, 0), Buildable(number, owner, shape, 0), NaturalAndForestZone(number, owner, shape)
+AgriculturalZone::AgriculturalZone(int number, string_view owner, PlotShape shape, string_view cropType) : Plot(number, owner, move(shape), 0), Buildable(number, owner, nullptr, 0), NaturalAndForestZone(number, owner, nullptr)
 {
 
     this->setType(PlotType::AGRICULTURAL_ZONE);
-    this->cropType = cropType;
-    int pBuildableArea = static_cast<int>((this->getBuildableArea() / this->NaturalAndForestZone::getArea()) * 100.0f);
+    this->cropTypeId = StringPool::getInstance().intern(cropType);
+    float area = this->NaturalAndForestZone::getArea();
+    int pBuildableArea = area > 0 ? static_cast<int>((this->getBuildableArea() / area) * 100.0f) : 0; // a null area is reported by validatePlots()
     this->Buildable::setPBuildable(pBuildableArea);
 }
 
@@ -488,7 +568,7 @@ AgriculturalZone::AgriculturalZone(int number, string owner, Polygon<int,float>*
  */
 AgriculturalZone::AgriculturalZone(const AgriculturalZone& a) : Plot(a), Buildable(a), NaturalAndForestZone(a)
 {
-    this->cropType = a.cropType;
+    this->cropTypeId = a.cropTypeId;
 }
 
 /**
@@ -512,11 +592,21 @@ void AgriculturalZone::setType(PlotType type)
 /**
  * @brief Get the crop type of the plot
  * 
- * @return string 
+ * @return const string& 
+ */
+const string& AgriculturalZone::getCropType() const
+{
+    return StringPool::getInstance().get(this->cropTypeId);
+}
+
+/**
+ * @brief Get the number of the crop type in the string pool
+ * 
+ * @return uint32_t 
  */
-string AgriculturalZone::getCropType() const
+uint32_t AgriculturalZone::getCropTypeId() const
 {
-    return this->cropType;
+    return this->cropTypeId;
 }
 
 /**
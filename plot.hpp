@@ -10,8 +10,11 @@
  */
 
 #include <iostream>
+#include <memory>
+#include <string_view>
 #include <vector>
 #include "polygon.hpp"
+#include "stringpool.hpp"
 
 #ifndef PLOT_HPP
 #define PLOT_HPP
@@ -37,6 +40,23 @@ enum PlotType {
  */
 string PlotTypeToString(PlotType type);
 
+/**
+ * @brief The PlotShape class is the shape given to a plot: a polygon owned by someone else, given by pointer, or a polygon the plot owns, given as a unique_ptr or moved in by value
+ * 
+ */
+class PlotShape
+{
+    private:
+        Polygon<int,float>* polygon;
+        unique_ptr<Polygon<int,float>> owned;
+    public:
+        PlotShape(Polygon<int,float>* polygon);
+        PlotShape(unique_ptr<Polygon<int,float>> polygon);
+        PlotShape(Polygon<int,float>&& polygon);
+        Polygon<int,float>* get() const;
+        unique_ptr<Polygon<int,float>> takeOwnership();
+};
+
 /**
  * @brief The Plot class is a base class for all types of plots
  */
@@ -44,39 +64,44 @@ class Plot
 {
     private:
         int number;
-        string owner;
-        float area; // in square meters
+        uint32_t ownerId; // in StringPool::getInstance()
+        mutable float area; // in square meters, recomputed by getArea() when the shape has changed
+        mutable uint64_t shapeVersion; // version of the shape the area was computed from
         Polygon<int,float>* shape;
+        unique_ptr<Polygon<int,float>> ownedShape; // set when the plot owns its shape
         int pBuildable; // percentage of buildable area of the plot
     protected:
         PlotType type;
     public:
-        Plot(int number, string owner, Polygon<int,float>* shape, int pBuildable);
+        Plot(int number, string_view owner, PlotShape shape, int pBuildable);
         Plot(const Plot& p);
-        ~Plot();
+        virtual ~Plot();
         int getPBuildable() const;
         int getNumber() const;
-        string getOwner() const;
+        const string& getOwner() const;
+        uint32_t getOwnerId() const;
         float getArea() const;
         Polygon<int,float>* getShape() const;
         PlotType getType() const;
         void setNumber(int number);
-        void setOwner(string owner);
-        void setShape(Polygon<int,float>* shape);
+        void setOwner(string_view owner);
+        void setShape(PlotShape shape);
         void setPBuildable(int pBuildable);
-        void calculateArea();
+        void calculateArea() const;
+        virtual float getBuildableArea() const;
         virtual void setType(PlotType type) = 0;
 
         friend ostream& operator<<(ostream& os, const Plot& p);
 };
 
 /**
- * @brief The Buildable class is an abstract class, specfying that a plot can be built on
+ * @brief The Buildable class is an abstract class, specfying that a plot can be built on.
+ * Plot is a virtual base, constructed by the most derived class only: the derived classes give their shape to Plot and nullptr to Buildable and NaturalAndForestZone
  */
 class Buildable : public virtual Plot
 {
     public:
-        Buildable(int number, string owner, Polygon<int,float>* shape, int pBuildable = 0);
+        Buildable(int number, string_view owner, PlotShape shape, int pBuildable = 0);
         Buildable(const Buildable& b);
         ~Buildable();
         virtual void setType(PlotType type) = 0;
@@ -86,16 +111,17 @@ class Buildable : public virtual Plot
 /**
  * @brief ZU already has a built surface area (in m2)
  */
-class UrbanZone : public Buildable
+class UrbanZone final : public Buildable
 {
     private:
         float builtArea;
     public:
-        UrbanZone(int number, string owner, Polygon<int,float>* shape, int pBuildable, float builtArea = 0);
+        UrbanZone(int number, string_view owner, PlotShape shape, int pBuildable, float builtArea = 0, bool randomIfUnspecified = true);
         UrbanZone(const UrbanZone& u);
         ~UrbanZone();
         void setType(PlotType type);
         float getBuiltArea() const;
+        void setBuiltArea(float builtArea);
         float getBuildableArea() const;
         friend ostream& operator<<(ostream& os, const UrbanZone& u);
 };
@@ -103,10 +129,10 @@ class UrbanZone : public Buildable
 /**
  * @brief ZAU has no built surface area
  */
-class ZoneToBeUrbanized : public Buildable
+class ZoneToBeUrbanized final : public Buildable
 {
     public:
-        ZoneToBeUrbanized(int number, string owner, Polygon<int,float>* shape, int pBuildable);
+        ZoneToBeUrbanized(int number, string_view owner, PlotShape shape, int pBuildable);
         ZoneToBeUrbanized(const ZoneToBeUrbanized& z);
         ~ZoneToBeUrbanized();
         void setType(PlotType type);
@@ -120,7 +146,7 @@ class ZoneToBeUrbanized : public Buildable
 class NaturalAndForestZone : public virtual Plot
 {
     public:
-        NaturalAndForestZone(int number, string owner, Polygon<int,float>* shape);
+        NaturalAndForestZone(int number, string_view owner, PlotShape shape);
         NaturalAndForestZone(const NaturalAndForestZone& n);
         ~NaturalAndForestZone();
         void setType(PlotType type);
@@ -130,16 +156,17 @@ class NaturalAndForestZone : public virtual Plot
 /**
  * @brief On ZA, a farmer can build agricultural buildings as long as the built surface area does not exceed 10% of the total area and a maximum of 200m2. The ZA also has additional characteristics like the type of cultivated crop
  */
-class AgriculturalZone : public NaturalAndForestZone, public Buildable
+class AgriculturalZone final : public NaturalAndForestZone, public Buildable
 {
     private:
-        string cropType;
+        uint32_t cropTypeId; // in StringPool::getInstance()
     public:
-        AgriculturalZone(int number, string owner, Polygon<int,float>* shape, string cropType);
+        AgriculturalZone(int number, string_view owner, PlotShape shape, string_view cropType);
         AgriculturalZone(const AgriculturalZone& a);
         ~AgriculturalZone();
         void setType(PlotType type);
-        string getCropType() const;
+        const string& getCropType() const;
+        uint32_t getCropTypeId() const;
         float getBuildableArea() const;
         friend ostream& operator<<(ostream& os, const AgriculturalZone& a);
 };
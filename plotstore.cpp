@@ -0,0 +1,265 @@
+/**
+ * @file plotstore.cpp
+ * @author Bastien, Victor, AlexisR 
+ * @brief Implementation file for the PlotStore class
+ * @version 0.1
+ * @date 2024-01-16
+ * 
+ * @copyright Copyright (c) 2024
+ * 
+ */
+
+#include <stdexcept>
+#include "plotstore.hpp"
+#include "parser.hpp"
+
+using namespace std;
+
+/**
+ * @brief Construct a new empty PlotStore::PlotStore object
+ * 
+ */
+PlotStore::PlotStore()
+{
+}
+
+/**
+ * @brief Construct a new PlotStore::PlotStore object from a file in the text format
+ * 
+ * @param filename
+ */
+PlotStore::PlotStore(const string& filename)
+{
+    this->load(filename);
+}
+
+/**
+ * @brief Replace the plots of the store by the plots of a file in the text format. The records are counted by type first, so that every vector is allocated once
+ * 
+ * @param filename
+ * @return bool false if the file cannot be opened
+ */
+bool PlotStore::load(const string& filename)
+{
+    STATS_TIME(LOAD_TEXT);
+    this->clear();
+    MappedFile file(filename);
+    if (!file.isOpen())
+    {
+        cout << "Unable to open file" << endl;
+        return false;
+    }
+
+    size_t counts[4] = {0, 0, 0, 0};
+    PlotRecord record;
+    RecordScanner counter(file.begin(), file.end());
+    while (counter.next(record))
+    {
+        if (record.type == "ZU") counts[PlotType::URBAN_ZONE]++;
+        else if (record.type == "ZAU") counts[PlotType::ZONE_TO_BE_URBANIZED]++;
+        else if (record.type == "ZN") counts[PlotType::NATURAL_AND_FOREST_ZONE]++;
+        else if (record.type == "ZA") counts[PlotType::AGRICULTURAL_ZONE]++;
+    }
+    size_t total = counts[0] + counts[1] + counts[2] + counts[3];
+    this->shapes.reserve(total);
+    this->order.reserve(total);
+    this->urbanZones.reserve(counts[PlotType::URBAN_ZONE]);
+    this->zonesToBeUrbanized.reserve(counts[PlotType::ZONE_TO_BE_URBANIZED]);
+    this->naturalAndForestZones.reserve(counts[PlotType::NATURAL_AND_FOREST_ZONE]);
+    this->agriculturalZones.reserve(counts[PlotType::AGRICULTURAL_ZONE]);
+
+    RecordScanner scanner(file.begin(), file.end());
+    while (scanner.next(record))
+    {
+        if (record.type != "ZU" && record.type != "ZAU" && record.type != "ZN" && record.type != "ZA")
+        {
+            continue;
+        }
+        pmr::vector<Point2D<int, float>> vertices(STATS_RESOURCE());
+        parseVertices(record.verticesBegin, record.verticesEnd, vertices);
+        this->shapes.emplace_back(move(vertices), false); // not checked for self-intersections, see validatePlots()
+        Polygon<int, float>* shape = &this->shapes.back();
+        if (record.type == "ZU")
+        {
+            this->order.emplace_back(PlotType::URBAN_ZONE, this->urbanZones.size());
+            this->urbanZones.emplace_back(record.number, record.owner, shape, record.pBuildable, record.builtArea, false);
+        }
+        else if (record.type == "ZAU")
+        {
+            this->order.emplace_back(PlotType::ZONE_TO_BE_URBANIZED, this->zonesToBeUrbanized.size());
+            this->zonesToBeUrbanized.emplace_back(record.number, record.owner, shape, record.pBuildable);
+        }
+        else if (record.type == "ZN")
+        {
+            this->order.emplace_back(PlotType::NATURAL_AND_FOREST_ZONE, this->naturalAndForestZones.size());
+            this->naturalAndForestZones.emplace_back(record.number, record.owner, shape);
+        }
+        else
+        {
+            this->order.emplace_back(PlotType::AGRICULTURAL_ZONE, this->agriculturalZones.size());
+            this->agriculturalZones.emplace_back(record.number, record.owner, shape, record.cropType);
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Remove all the plots of the store
+ * 
+ */
+void PlotStore::clear()
+{
+    // the plots first, they point to the shapes
+    this->order.clear();
+    this->urbanZones.clear();
+    this->zonesToBeUrbanized.clear();
+    this->naturalAndForestZones.clear();
+    this->agriculturalZones.clear();
+    this->shapes.clear();
+}
+
+/**
+ * @brief Get the number of plots of the store
+ * 
+ * @return size_t
+ */
+size_t PlotStore::size() const
+{
+    return this->order.size();
+}
+
+/**
+ * @brief Get the urban zones (ZU) of the store
+ * 
+ * @return const vector<UrbanZone>&
+ */
+const vector<UrbanZone>& PlotStore::getUrbanZones() const
+{
+    return this->urbanZones;
+}
+
+/**
+ * @brief Get the zones to be urbanized (ZAU) of the store
+ * 
+ * @return const vector<ZoneToBeUrbanized>&
+ */
+const vector<ZoneToBeUrbanized>& PlotStore::getZonesToBeUrbanized() const
+{
+    return this->zonesToBeUrbanized;
+}
+
+/**
+ * @brief Get the natural and forest zones (ZN) of the store
+ * 
+ * @return const vector<NaturalAndForestZone>&
+ */
+const vector<NaturalAndForestZone>& PlotStore::getNaturalAndForestZones() const
+{
+    return this->naturalAndForestZones;
+}
+
+/**
+ * @brief Get the agricultural zones (ZA) of the store
+ * 
+ * @return const vector<AgriculturalZone>&
+ */
+const vector<AgriculturalZone>& PlotStore::getAgriculturalZones() const
+{
+    return this->agriculturalZones;
+}
+
+/**
+ * @brief Get the sum of the areas of all the plots
+ * 
+ * @return float in square meters
+ */
+float PlotStore::getTotalArea() const
+{
+    float total = 0;
+    this->forEachPlotByType([&total](const auto& plot) { total += plot.getArea(); });
+    return total;
+}
+
+/**
+ * @brief Get the area that can still be built on, summed over the buildable plots (ZU, ZAU and ZA)
+ * 
+ * @return float in square meters
+ */
+float PlotStore::getBuildableArea() const
+{
+    float total = 0;
+    for (const auto& plot : this->urbanZones)
+    {
+        total += plot.getBuildableArea();
+    }
+    for (const auto& plot : this->zonesToBeUrbanized)
+    {
+        total += plot.getBuildableArea();
+    }
+    for (const auto& plot : this->agriculturalZones)
+    {
+        total += plot.getBuildableArea();
+    }
+    return total;
+}
+
+/**
+ * @brief Write all the plots in the text format, in file order
+ * 
+ * @param os
+ */
+void PlotStore::writeText(ostream& os) const
+{
+    STATS_TIME(SAVE_TEXT);
+    this->forEachPlot([&os](const auto& plot) { writePlotText(os, plot); });
+}
+
+/**
+ * @brief Write the header line of a plot up to its type specific fields
+ * 
+ */
+static void writeHeader(ostream& os, const Plot& plot)
+{
+    os << PlotTypeToString(plot.getType()) << " " << plot.getNumber() << " " << plot.getOwner() << " ";
+}
+
+/**
+ * @brief Write the vertices line of a plot
+ * 
+ */
+static void writeVertices(ostream& os, const Plot& plot)
+{
+    os << "\n";
+    for (const auto& vertex : plot.getShape()->getVertexView())
+    {
+        os << "[" << vertex.getX() << ";" << vertex.getY() << "] ";
+    }
+    os << "\n";
+}
+
+void writePlotText(ostream& os, const UrbanZone& plot)
+{
+    writeHeader(os, plot);
+    os << plot.getPBuildable() << " " << plot.getBuiltArea();
+    writeVertices(os, plot);
+}
+
+void writePlotText(ostream& os, const ZoneToBeUrbanized& plot)
+{
+    writeHeader(os, plot);
+    os << plot.getPBuildable();
+    writeVertices(os, plot);
+}
+
+void writePlotText(ostream& os, const NaturalAndForestZone& plot)
+{
+    writeHeader(os, plot);
+    writeVertices(os, plot);
+}
+
+void writePlotText(ostream& os, const AgriculturalZone& plot)
+{
+    writeHeader(os, plot);
+    os << plot.getCropType();
+    writeVertices(os, plot);
+}
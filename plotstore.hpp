@@ -0,0 +1,136 @@
+/**
+ * @file plotstore.hpp
+ * @author Bastien, Victor, AlexisR 
+ * @brief Header file for the PlotStore class
+ * @version 0.1
+ * @date 2024-01-16
+ * 
+ * @copyright Copyright (c) 2024
+ * 
+ */
+
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+#include "plot.hpp"
+
+#ifndef PLOTSTORE_HPP
+#define PLOTSTORE_HPP
+
+using namespace std;
+
+/**
+ * @brief The PlotStore class keeps the plots of a file partitioned by type, each type in its own contiguous vector of objects.
+ * Since the exact class of every plot is known, code going through the store is dispatched statically: no dynamic_cast, and calls to getBuildableArea() are not virtual.
+ * The plots point to their shape in the shapes vector, so it is sized once on load and never grows afterwards
+ * 
+ */
+class PlotStore
+{
+    private:
+        vector<Polygon<int, float>> shapes;
+        vector<UrbanZone> urbanZones;
+        vector<ZoneToBeUrbanized> zonesToBeUrbanized;
+        vector<NaturalAndForestZone> naturalAndForestZones;
+        vector<AgriculturalZone> agriculturalZones;
+        vector<pair<PlotType, uint32_t>> order; // type and position in its vector of every plot, in file order
+    public:
+        PlotStore();
+        PlotStore(const string& filename);
+        PlotStore(const PlotStore& s) = delete;
+        PlotStore& operator=(const PlotStore& s) = delete;
+        bool load(const string& filename);
+        void clear();
+        size_t size() const;
+        const vector<UrbanZone>& getUrbanZones() const;
+        const vector<ZoneToBeUrbanized>& getZonesToBeUrbanized() const;
+        const vector<NaturalAndForestZone>& getNaturalAndForestZones() const;
+        const vector<AgriculturalZone>& getAgriculturalZones() const;
+        float getTotalArea() const;
+        float getBuildableArea() const;
+        void writeText(ostream& os) const;
+
+        /**
+         * @brief Call visit on every plot in file order, with the plot as its own class
+         *
+         * @tparam Visitor callable with a const reference to each of the four plot classes
+         * @param visit
+         */
+        template <typename Visitor>
+        void forEachPlot(Visitor visit) const
+        {
+            for (size_t i = 0; i < this->order.size(); i++)
+            {
+                visitPlot(i, visit);
+            }
+        }
+
+        /**
+         * @brief Call visit on the plot at position i in file order, with the plot as its own class
+         *
+         * @tparam Visitor callable with a const reference to each of the four plot classes
+         * @param i
+         * @param visit
+         */
+        template <typename Visitor>
+        void visitPlot(size_t i, Visitor&& visit) const
+        {
+            const auto& entry = this->order[i];
+            switch (entry.first)
+            {
+                case PlotType::URBAN_ZONE:
+                    visit(this->urbanZones[entry.second]);
+                    break;
+                case PlotType::ZONE_TO_BE_URBANIZED:
+                    visit(this->zonesToBeUrbanized[entry.second]);
+                    break;
+                case PlotType::NATURAL_AND_FOREST_ZONE:
+                    visit(this->naturalAndForestZones[entry.second]);
+                    break;
+                case PlotType::AGRICULTURAL_ZONE:
+                    visit(this->agriculturalZones[entry.second]);
+                    break;
+            }
+        }
+
+        /**
+         * @brief Call visit on every plot, one type after the other. Faster than forEachPlot() when the order does not matter
+         *
+         * @tparam Visitor callable with a const reference to each of the four plot classes
+         * @param visit
+         */
+        template <typename Visitor>
+        void forEachPlotByType(Visitor visit) const
+        {
+            for (const auto& plot : this->urbanZones)
+            {
+                visit(plot);
+            }
+            for (const auto& plot : this->zonesToBeUrbanized)
+            {
+                visit(plot);
+            }
+            for (const auto& plot : this->naturalAndForestZones)
+            {
+                visit(plot);
+            }
+            for (const auto& plot : this->agriculturalZones)
+            {
+                visit(plot);
+            }
+        }
+};
+
+/**
+ * @brief Write a plot in the text format, the same as the input files
+ * 
+ * @param os
+ * @param plot
+ */
+void writePlotText(ostream& os, const UrbanZone& plot);
+void writePlotText(ostream& os, const ZoneToBeUrbanized& plot);
+void writePlotText(ostream& os, const NaturalAndForestZone& plot);
+void writePlotText(ostream& os, const AgriculturalZone& plot);
+
+#endif // PLOTSTORE_HPP
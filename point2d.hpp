@@ -34,8 +34,12 @@ private:
     U y;
 public:
     Point2D(T x, U y);
-    ~Point2D();
-    Point2D(const Point2D<T, U>& p);
+    // defaulted, so that the points stay trivially copyable and movable and vectors of points are copied with memcpy
+    ~Point2D() = default;
+    Point2D(const Point2D<T, U>& p) = default;
+    Point2D(Point2D<T, U>&& p) = default;
+    Point2D<T, U>& operator=(const Point2D<T, U>& p) = default;
+    Point2D<T, U>& operator=(Point2D<T, U>&& p) = default;
     void translate(T dx, U dy);
     T getX() const;
     U getY() const;
@@ -60,31 +64,6 @@ Point2D<T, U>::Point2D(T x, U y)
     this->y = y;
 }
 
-/**
- * @brief Destroy the Point2D<T, U>:: Point2D object
- * 
- * @tparam T 
- * @tparam U 
- */
-template <typename T, typename U>
-Point2D<T, U>::~Point2D()
-{
-}
-
-/**
- * @brief Construct a new Point2D<T, U>:: Point2D object from another Point2D
- * 
- * @tparam T 
- * @tparam U 
- * @param p 
- */
-template <typename T, typename U>
-Point2D<T, U>::Point2D(const Point2D<T, U>& p)
-{
-    this->x = p.x;
-    this->y = p.y;
-}
-
 /**
  * @brief Translates the point by dx and dy
  * 
@@ -11,8 +11,15 @@
 
 #include <iostream>
 #include <vector>
+#include <memory_resource>
 #include "point2d.hpp"
-#include <functional>
+#include "boundingbox.hpp"
+#include "intersection.hpp"
+#include "shoelace.hpp"
+#include "stats.hpp"
+#include <cstdint>
+#include <stdexcept>
+#include <string>
 
 #ifndef POLYGON_HPP
 #define POLYGON_HPP
@@ -22,9 +29,32 @@ using namespace std;
 template <typename T, typename U>
 class Polygon;
 
+template <typename T, typename U>
+class PolygonEditor;
+
 template <typename T, typename U>
 ostream& operator<<(ostream& os, const Polygon<T, U>& p);
 
+/**
+ * @brief Non-owning, read-only view over the vertices of a Polygon. It does not copy the vertices, so it is only valid as long as the polygon is not modified or destroyed
+ * 
+ */
+template <typename T, typename U>
+class VertexView
+{
+    private:
+        const Point2D<T, U>* first;
+        size_t count;
+    public:
+        VertexView(const Point2D<T, U>* first, size_t count) : first(first), count(count) {}
+        const Point2D<T, U>* begin() const { return first; }
+        const Point2D<T, U>* end() const { return first + count; }
+        const Point2D<T, U>* data() const { return first; }
+        size_t size() const { return count; }
+        bool empty() const { return count == 0; }
+        const Point2D<T, U>& operator[](size_t i) const { return first[i]; }
+};
+
 /**
  * @brief The Polygon class is a class that represents a polygon in a 2D space. It is templated to allow for different types of coordinates (int, float, double, etc.)
  * 
@@ -33,24 +63,43 @@ template <typename T, typename U>
 class Polygon
 {
     private:
-        vector<Point2D<T, U>> vertices;
-        vector<function<void()>> observers;
-        void notifyObservers() {
-            for (const auto& observer : observers){
-                observer();
-            }
-                
-        }
+        pmr::vector<Point2D<T, U>> vertices; // allocated from the memory resource given at construction, the heap by default
+        typename Shoelace<T, U>::Accumulator twiceArea; // running shoelace sum in fixed point, kept up to date by every modification. Being exact, it does not drift with the updates
+        EdgeIndex edgeIndex; // edges sorted by x, used to check only the new edges in addVertex()
+        bool edgeIndexValid;
+        uint64_t version; // incremented by every modification, so that the plots can tell when to recompute what they derive from the shape
+        bool validated; // known not to intersect itself: false only for polygons built unchecked by the loaders, until their vertices are set again
+        void computeTwiceArea();
+        static void validate(const Point2D<T, U>* vertices, size_t n);
+        static void throwIntersection(size_t first, size_t second);
+        void indexEdge(size_t i, bool insert);
+        bool newEdgeIntersects(size_t edge);
     public:
         Polygon();
+        Polygon(pmr::memory_resource* resource);
         ~Polygon();
-        Polygon(vector<Point2D<T, U>> vertices);
+        Polygon(const vector<Point2D<T, U>>& vertices);
+        Polygon(pmr::vector<Point2D<T, U>>&& vertices, bool check = true);
         Polygon(const Polygon<T, U>& p);
+        Polygon(Polygon<T, U>&& p) noexcept;
+        Polygon<T, U>& operator=(const Polygon<T, U>& p);
+        Polygon<T, U>& operator=(Polygon<T, U>&& p);
         vector<Point2D<T, U>> getVertices() const;
+        VertexView<T, U> getVertexView() const;
         void setVertices(const vector<Point2D<T, U>> &vertices);
+        void setVertices(pmr::vector<Point2D<T, U>>&& vertices);
+        void reserve(size_t n);
         void addVertex(const Point2D<T, U> &p);
+        void emplaceVertex(T x, U y);
+        void setVertex(size_t i, const Point2D<T, U> &p);
+        double getSignedArea() const;
+        typename Shoelace<T, U>::Accumulator getTwiceArea() const;
+        BoundingBox getBoundingBox() const;
+        bool contains(double x, double y) const;
         void translate(T dx, U dy);
-        void addObserver(function<void()> observer); 
+        uint64_t getVersion() const;
+        bool isValidated() const;
+        PolygonEditor<T, U> edit();
 
         friend ostream& operator<< <T, U>(ostream& os, const Polygon& p);
 };
@@ -62,8 +111,30 @@ class Polygon
  * @tparam U 
  */
 template <typename T, typename U>
-Polygon<T, U>::Polygon()
+Polygon<T, U>::Polygon() : vertices(STATS_RESOURCE())
+{
+    STATS_ADD(POLYGONS_CONSTRUCTED, 1);
+    this->twiceArea = 0;
+    this->edgeIndexValid = false;
+    this->version = 0;
+    this->validated = true;
+}
+
+/**
+ * @brief Construct a new empty Polygon<T, U>::Polygon object whose vertices are allocated from resource, e.g. an Arena
+ * 
+ * @tparam T 
+ * @tparam U 
+ * @param resource 
+ */
+template <typename T, typename U>
+Polygon<T, U>::Polygon(pmr::memory_resource* resource) : vertices(resource)
 {
+    STATS_ADD(POLYGONS_CONSTRUCTED, 1);
+    this->twiceArea = 0;
+    this->edgeIndexValid = false;
+    this->version = 0;
+    this->validated = true;
 }
 
 /**
@@ -78,16 +149,44 @@ Polygon<T, U>::~Polygon()
 }
 
 /**
- * @brief Construct a new Polygon<T, U>::Polygon object
+ * @brief Construct a new Polygon<T, U>::Polygon object. The vertices are copied once. Throws an exception if the polygon intersects itself
  * 
  * @tparam T 
  * @tparam U 
  * @param vertices 
  */
 template <typename T, typename U>
-Polygon<T, U>::Polygon(vector<Point2D<T, U>> vertices)
+Polygon<T, U>::Polygon(const vector<Point2D<T, U>>& vertices) : vertices(STATS_RESOURCE())
 {
-    this->vertices = vertices;
+    STATS_ADD(POLYGONS_CONSTRUCTED, 1);
+    validate(vertices.data(), vertices.size());
+    this->edgeIndexValid = false;
+    this->version = 0;
+    this->validated = true;
+    this->vertices.assign(vertices.begin(), vertices.end());
+    computeTwiceArea();
+}
+
+/**
+ * @brief Construct a new Polygon<T, U>::Polygon object taking over a vector of vertices, without copying them. The polygon allocates from the memory resource of the vector. Throws an exception if the polygon intersects itself
+ * 
+ * @tparam T 
+ * @tparam U 
+ * @param vertices 
+ * @param check if false, the polygon is kept even if it intersects itself, and isValidated() is false: the loaders keep every plot of a file and leave the check to validatePlots()
+ */
+template <typename T, typename U>
+Polygon<T, U>::Polygon(pmr::vector<Point2D<T, U>>&& vertices, bool check) : vertices(move(vertices))
+{
+    STATS_ADD(POLYGONS_CONSTRUCTED, 1);
+    if (check)
+    {
+        validate(this->vertices.data(), this->vertices.size());
+    }
+    this->edgeIndexValid = false;
+    this->version = 0;
+    this->validated = check;
+    computeTwiceArea();
 }
 
 /**
@@ -98,9 +197,183 @@ Polygon<T, U>::Polygon(vector<Point2D<T, U>> vertices)
  * @param p 
  */
 template <typename T, typename U>
-Polygon<T, U>::Polygon(const Polygon<T, U>& p)
+Polygon<T, U>::Polygon(const Polygon<T, U>& p) : vertices(STATS_RESOURCE())
 {
+    STATS_ADD(POLYGONS_COPIED, 1);
     this->vertices = p.vertices;
+    this->twiceArea = p.twiceArea;
+    this->edgeIndexValid = false;
+    this->version = p.version;
+    this->validated = p.validated;
+}
+
+/**
+ * @brief Construct a new Polygon<T, U>::Polygon object by moving another Polygon, which is left empty. The vertices keep their memory resource
+ * 
+ * @tparam T 
+ * @tparam U 
+ * @param p 
+ */
+template <typename T, typename U>
+Polygon<T, U>::Polygon(Polygon<T, U>&& p) noexcept : vertices(move(p.vertices)), edgeIndex(move(p.edgeIndex))
+{
+    this->twiceArea = p.twiceArea;
+    this->edgeIndexValid = p.edgeIndexValid;
+    this->version = p.version;
+    this->validated = p.validated;
+    p.vertices.clear();
+    p.twiceArea = 0;
+    p.edgeIndexValid = false;
+    p.version++;
+    p.validated = true;
+}
+
+/**
+ * @brief Copy the vertices of another Polygon. This is a modification: the plots using this polygon will recompute their area
+ * 
+ * @tparam T 
+ * @tparam U 
+ * @param p 
+ * @return Polygon<T, U>& 
+ */
+template <typename T, typename U>
+Polygon<T, U>& Polygon<T, U>::operator=(const Polygon<T, U>& p)
+{
+    if (this != &p)
+    {
+        this->vertices.assign(p.vertices.begin(), p.vertices.end());
+        this->twiceArea = p.twiceArea;
+        this->edgeIndexValid = false;
+        this->version++;
+        this->validated = p.validated;
+    }
+    return *this;
+}
+
+/**
+ * @brief Move the vertices of another Polygon, which is left empty. The vertices are only copied if the two polygons use different memory resources. This is a modification: the plots using this polygon will recompute their area
+ * 
+ * @tparam T 
+ * @tparam U 
+ * @param p 
+ * @return Polygon<T, U>& 
+ */
+template <typename T, typename U>
+Polygon<T, U>& Polygon<T, U>::operator=(Polygon<T, U>&& p)
+{
+    if (this != &p)
+    {
+        this->vertices = move(p.vertices);
+        this->twiceArea = p.twiceArea;
+        this->edgeIndexValid = false;
+        this->version++;
+        this->validated = p.validated;
+        p.vertices.clear();
+        p.twiceArea = 0;
+        p.edgeIndexValid = false;
+        p.version++;
+        p.validated = true;
+    }
+    return *this;
+}
+
+/**
+ * @brief Throw an exception if the polygon intersects itself, using the Shamos-Hoey sweep line in O(n log n)
+ * 
+ * @tparam T 
+ * @tparam U 
+ * @param vertices 
+ * @param n 
+ */
+template <typename T, typename U>
+void Polygon<T, U>::validate(const Point2D<T, U>* vertices, size_t n)
+{
+    size_t first, second;
+    if (findSelfIntersection(vertices, n, first, second))
+    {
+        throwIntersection(first, second);
+    }
+}
+
+/**
+ * @brief Throw the exception reporting that two edges intersect
+ * 
+ * @tparam T 
+ * @tparam U 
+ * @param first 
+ * @param second 
+ */
+template <typename T, typename U>
+void Polygon<T, U>::throwIntersection(size_t first, size_t second)
+{
+    throw runtime_error("The polygon intersects itself (edges " + to_string(first) + " and " + to_string(second) + ")");
+}
+
+/**
+ * @brief Add or remove edge i (from vertex i to the next one) in the edge index
+ * 
+ * @tparam T 
+ * @tparam U 
+ * @param i 
+ * @param insert 
+ */
+template <typename T, typename U>
+void Polygon<T, U>::indexEdge(size_t i, bool insert)
+{
+    double x1 = this->vertices[i].getX();
+    double x2 = this->vertices[(i + 1) % this->vertices.size()].getX();
+    if (insert)
+    {
+        this->edgeIndex.insert(i, x1, x2);
+    }
+    else
+    {
+        this->edgeIndex.erase(i, x1, x2);
+    }
+}
+
+/**
+ * @brief Check a new edge against the indexed edges whose x range overlaps it
+ * 
+ * @tparam T 
+ * @tparam U 
+ * @param edge 
+ * @return bool 
+ */
+template <typename T, typename U>
+bool Polygon<T, U>::newEdgeIntersects(size_t edge)
+{
+    size_t n = this->vertices.size();
+    const Point2D<T, U>* v = this->vertices.data();
+    return this->edgeIndex.visitOverlapping(v[edge].getX(), v[(edge + 1) % n].getX(), [&](size_t other) {
+        if (edgesIntersect(v, n, other, edge))
+        {
+            throwIntersection(min(other, edge), max(other, edge));
+        }
+        return false;
+    });
+}
+
+/**
+ * @brief Recompute the shoelace sum from scratch, used when all the vertices are replaced
+ * 
+ * @tparam T 
+ * @tparam U 
+ */
+template <typename T, typename U>
+void Polygon<T, U>::computeTwiceArea()
+{
+    STATS_ADD(POLYGON_AREA_RECOMPUTATIONS, 1);
+    this->twiceArea = 0;
+    size_t n = this->vertices.size();
+    for (size_t i = 0; i + 1 < n; i++)
+    {
+        this->twiceArea += Shoelace<T, U>::cross(this->vertices[i], this->vertices[i+1]);
+    }
+    if (n > 0)
+    {
+        this->twiceArea += Shoelace<T, U>::cross(this->vertices[n-1], this->vertices[0]);
+    }
 }
 
 /**
@@ -113,11 +386,26 @@ Polygon<T, U>::Polygon(const Polygon<T, U>& p)
 template <typename T, typename U>
 vector<Point2D<T, U>> Polygon<T, U>::getVertices() const
 {
-    return this->vertices;
+    STATS_ADD(VERTEX_COPIES, 1);
+    STATS_ADD(VERTICES_COPIED, this->vertices.size());
+    return vector<Point2D<T, U>>(this->vertices.begin(), this->vertices.end());
 }
 
 /**
- * @brief Set the vertices of the polygon
+ * @brief Get a view of the vertices of the polygon, without copying them
+ * 
+ * @tparam T 
+ * @tparam U 
+ * @return VertexView<T, U> 
+ */
+template <typename T, typename U>
+VertexView<T, U> Polygon<T, U>::getVertexView() const
+{
+    return VertexView<T, U>(this->vertices.data(), this->vertices.size());
+}
+
+/**
+ * @brief Set the vertices of the polygon. Throws an exception, leaving the polygon unchanged, if the new polygon intersects itself
  * 
  * @tparam T 
  * @tparam U 
@@ -126,12 +414,47 @@ vector<Point2D<T, U>> Polygon<T, U>::getVertices() const
 template <typename T, typename U>
 void Polygon<T, U>::setVertices(const vector<Point2D<T, U>> &vertices)
 {
-    this->vertices = vertices;
-    notifyObservers();
+    validate(vertices.data(), vertices.size());
+    this->edgeIndexValid = false;
+    this->vertices.assign(vertices.begin(), vertices.end());
+    computeTwiceArea();
+    this->version++;
+    this->validated = true;
 }
 
 /**
- * @brief Add a vertex to the polygon
+ * @brief Set the vertices of the polygon, taking over the vector without copying it when it uses the same memory resource as the polygon. Throws an exception, leaving the polygon unchanged, if the new polygon intersects itself
+ * 
+ * @tparam T 
+ * @tparam U 
+ * @param vertices 
+ */
+template <typename T, typename U>
+void Polygon<T, U>::setVertices(pmr::vector<Point2D<T, U>>&& vertices)
+{
+    validate(vertices.data(), vertices.size());
+    this->edgeIndexValid = false;
+    this->vertices = move(vertices);
+    computeTwiceArea();
+    this->version++;
+    this->validated = true;
+}
+
+/**
+ * @brief Reserve room for n vertices, before adding them one by one
+ * 
+ * @tparam T 
+ * @tparam U 
+ * @param n 
+ */
+template <typename T, typename U>
+void Polygon<T, U>::reserve(size_t n)
+{
+    this->vertices.reserve(n);
+}
+
+/**
+ * @brief Add a vertex to the polygon, see emplaceVertex()
  * 
  * @tparam T 
  * @tparam U 
@@ -140,12 +463,189 @@ void Polygon<T, U>::setVertices(const vector<Point2D<T, U>> &vertices)
 template <typename T, typename U>
 void Polygon<T, U>::addVertex(const Point2D<T, U> &p)
 {
-    this->vertices.push_back(p);
-    notifyObservers();
+    emplaceVertex(p.getX(), p.getY());
+}
+
+/**
+ * @brief Add a vertex to the polygon. Throws an exception, leaving the polygon unchanged, if the polygon would intersect itself.
+ * Only the two new edges are checked, against the edges of the index overlapping them. The vertex is constructed in place
+ * 
+ * @tparam T 
+ * @tparam U 
+ * @param x 
+ * @param y 
+ */
+template <typename T, typename U>
+void Polygon<T, U>::emplaceVertex(T x, U y)
+{
+    size_t n = this->vertices.size();
+    if (n < 3)
+    {
+        // too few edges to keep an index, check the whole polygon
+        this->vertices.emplace_back(x, y);
+        size_t first, second;
+        if (findSelfIntersection(this->vertices.data(), n + 1, first, second))
+        {
+            this->vertices.pop_back();
+            throwIntersection(first, second);
+        }
+        this->edgeIndexValid = false;
+        this->validated = true; // the whole polygon was checked
+    }
+    else
+    {
+        if (!this->edgeIndexValid)
+        {
+            this->edgeIndex.clear();
+            for (size_t i = 0; i < n; i++)
+            {
+                indexEdge(i, true);
+            }
+            this->edgeIndexValid = true;
+        }
+        // the closing edge n-1 (last, first) is replaced by the edges n-1 (last, p) and n (p, first)
+        indexEdge(n - 1, false);
+        this->vertices.emplace_back(x, y);
+        try
+        {
+            newEdgeIntersects(n - 1);
+            newEdgeIntersects(n);
+            if (edgesIntersect(this->vertices.data(), n + 1, n - 1, n))
+            {
+                throwIntersection(n - 1, n);
+            }
+        }
+        catch (const runtime_error& e)
+        {
+            this->vertices.pop_back();
+            indexEdge(n - 1, true);
+            throw;
+        }
+        indexEdge(n - 1, true);
+        indexEdge(n, true);
+    }
+    if (n > 0)
+    {
+        const Point2D<T, U>& first = this->vertices[0];
+        const Point2D<T, U>& last = this->vertices[n - 1];
+        const Point2D<T, U>& p = this->vertices[n];
+        this->twiceArea += Shoelace<T, U>::cross(last, p) + Shoelace<T, U>::cross(p, first) - Shoelace<T, U>::cross(last, first);
+    }
+    this->version++;
 }
 
 /**
- * @brief Translates the polygon by dx and dy
+ * @brief Replace the vertex at index i. The area is updated from the two edges touching that vertex only, and only these two edges are checked for intersections. Throws an exception, leaving the polygon unchanged, if the polygon would intersect itself
+ * or if there is no vertex i
+ * 
+ * @tparam T 
+ * @tparam U 
+ * @param i 
+ * @param p 
+ */
+template <typename T, typename U>
+void Polygon<T, U>::setVertex(size_t i, const Point2D<T, U> &p)
+{
+    size_t n = this->vertices.size();
+    if (i >= n)
+    {
+        throw out_of_range("Vertex index out of range");
+    }
+    const Point2D<T, U>& previous = this->vertices[(i + n - 1) % n];
+    const Point2D<T, U>& next = this->vertices[(i + 1) % n];
+    Point2D<T, U> old = this->vertices[i];
+    this->vertices[i] = p;
+    if (n >= 3)
+    {
+        size_t before = (i + n - 1) % n;
+        for (size_t k = 0; k < n; k++)
+        {
+            size_t moved = edgesIntersect(this->vertices.data(), n, k, before) ? before : i;
+            if (moved == before || edgesIntersect(this->vertices.data(), n, k, i))
+            {
+                this->vertices[i] = old;
+                throwIntersection(min(k, moved), max(k, moved));
+            }
+        }
+    }
+    this->edgeIndexValid = false;
+    this->twiceArea -= Shoelace<T, U>::cross(previous, old) + Shoelace<T, U>::cross(old, next);
+    this->twiceArea += Shoelace<T, U>::cross(previous, p) + Shoelace<T, U>::cross(p, next);
+    this->version++;
+}
+
+/**
+ * @brief Get the signed area of the polygon, positive when the vertices are in counterclockwise order. This is read from the running sum, in O(1), and rounded once
+ * 
+ * @tparam T 
+ * @tparam U 
+ * @return double 
+ */
+template <typename T, typename U>
+double Polygon<T, U>::getSignedArea() const
+{
+    return Shoelace<T, U>::toDouble(this->twiceArea) / 2;
+}
+
+/**
+ * @brief Get the exact running shoelace sum, i.e. twice the signed area scaled by 2^Shoelace<T, U>::FRACTION_BITS. Sums of these are exact, whatever their order
+ * 
+ * @tparam T 
+ * @tparam U 
+ * @return Shoelace<T, U>::Accumulator 
+ */
+template <typename T, typename U>
+typename Shoelace<T, U>::Accumulator Polygon<T, U>::getTwiceArea() const
+{
+    return this->twiceArea;
+}
+
+/**
+ * @brief Get the smallest axis-aligned rectangle containing the polygon
+ * 
+ * @tparam T 
+ * @tparam U 
+ * @return BoundingBox 
+ */
+template <typename T, typename U>
+BoundingBox Polygon<T, U>::getBoundingBox() const
+{
+    BoundingBox box;
+    for (const auto& vertex : this->vertices)
+    {
+        box.expand(vertex.getX(), vertex.getY());
+    }
+    return box;
+}
+
+/**
+ * @brief Check if a point is inside the polygon, by counting the edges crossed by a horizontal ray starting at the point (even-odd rule)
+ * 
+ * @tparam T 
+ * @tparam U 
+ * @param x 
+ * @param y 
+ * @return bool 
+ */
+template <typename T, typename U>
+bool Polygon<T, U>::contains(double x, double y) const
+{
+    bool inside = false;
+    size_t n = this->vertices.size();
+    for (size_t i = 0, j = n - 1; i < n; j = i++)
+    {
+        double xi = this->vertices[i].getX(), yi = this->vertices[i].getY();
+        double xj = this->vertices[j].getX(), yj = this->vertices[j].getY();
+        if ((yi > y) != (yj > y) && x < (xj - xi) * (y - yi) / (yj - yi) + xi)
+        {
+            inside = !inside;
+        }
+    }
+    return inside;
+}
+
+/**
+ * @brief Translates the polygon by dx and dy. The area does not change, so the running sum is left as is
  * 
  * @tparam T 
  * @tparam U 
@@ -159,19 +659,38 @@ void Polygon<T, U>::translate(T dx, U dy)
     {
         this->vertices[i].translate(dx, dy);
     }
+    if (Shoelace<T, U>::FRACTION_BITS > 0) // the area is unchanged, unless floating point coordinates were rounded
+    {
+        computeTwiceArea();
+    }
+    this->edgeIndexValid = false;
+    this->version++;
+}
+
+/**
+ * @brief Get the version of the polygon, which changes each time the polygon is modified
+ * 
+ * @tparam T 
+ * @tparam U 
+ * @return uint64_t 
+ */
+template <typename T, typename U>
+uint64_t Polygon<T, U>::getVersion() const
+{
+    return this->version;
 }
 
 /**
- * @brief Add an observer to the polygon
+ * @brief Check if the polygon is known not to intersect itself. Only a polygon built unchecked, as the loaders do, is not, until its vertices are set again; validatePlots() checks it
  * 
  * @tparam T 
  * @tparam U 
- * @param observer 
+ * @return bool 
  */
 template <typename T, typename U>
-void Polygon<T, U>::addObserver(function<void()> observer)
+bool Polygon<T, U>::isValidated() const
 {
-    observers.push_back(observer);
+    return this->validated;
 }
 
 /**
@@ -194,4 +713,203 @@ ostream& operator<<(ostream& os, const Polygon<T, U>& p)
     return os;
 }
 
+/**
+ * @brief The PolygonEditor class batches modifications of a polygon. The edits are applied to a working copy of the vertices, and commit() validates the result and updates the polygon once: one check for self-intersections, one computation of the area and one new version, whatever the number of edits.
+ * The polygon is left untouched until commit(); edits that are not committed are discarded when the editor is destroyed
+ * 
+ */
+template <typename T, typename U>
+class PolygonEditor
+{
+    private:
+        Polygon<T, U>* polygon;
+        vector<Point2D<T, U>> vertices;
+        bool committed;
+    public:
+        PolygonEditor(Polygon<T, U>& polygon);
+        PolygonEditor(const PolygonEditor<T, U>& e) = delete;
+        PolygonEditor<T, U>& operator=(const PolygonEditor<T, U>& e) = delete;
+        size_t size() const;
+        const Point2D<T, U>& getVertex(size_t i) const;
+        void reserve(size_t n);
+        void addVertex(const Point2D<T, U>& p);
+        void insertVertex(size_t i, const Point2D<T, U>& p);
+        void removeVertex(size_t i);
+        void moveVertex(size_t i, const Point2D<T, U>& p);
+        void clear();
+        void commit();
+        bool isCommitted() const;
+};
+
+/**
+ * @brief Start a batch of modifications of the polygon
+ * 
+ * @tparam T 
+ * @tparam U 
+ * @return PolygonEditor<T, U> 
+ */
+template <typename T, typename U>
+PolygonEditor<T, U> Polygon<T, U>::edit()
+{
+    return PolygonEditor<T, U>(*this);
+}
+
+/**
+ * @brief Construct a new PolygonEditor<T, U>::PolygonEditor object, starting from the current vertices of the polygon
+ * 
+ * @tparam T 
+ * @tparam U 
+ * @param polygon 
+ */
+template <typename T, typename U>
+PolygonEditor<T, U>::PolygonEditor(Polygon<T, U>& polygon) : polygon(&polygon), committed(false)
+{
+    VertexView<T, U> view = polygon.getVertexView();
+    this->vertices.assign(view.begin(), view.end());
+}
+
+/**
+ * @brief Get the number of vertices after the edits made so far
+ * 
+ * @tparam T 
+ * @tparam U 
+ * @return size_t 
+ */
+template <typename T, typename U>
+size_t PolygonEditor<T, U>::size() const
+{
+    return this->vertices.size();
+}
+
+/**
+ * @brief Get a vertex after the edits made so far
+ * 
+ * @tparam T 
+ * @tparam U 
+ * @param i 
+ * @return const Point2D<T, U>& 
+ */
+template <typename T, typename U>
+const Point2D<T, U>& PolygonEditor<T, U>::getVertex(size_t i) const
+{
+    return this->vertices.at(i);
+}
+
+/**
+ * @brief Reserve room for n vertices, before adding many of them
+ * 
+ * @tparam T 
+ * @tparam U 
+ * @param n 
+ */
+template <typename T, typename U>
+void PolygonEditor<T, U>::reserve(size_t n)
+{
+    this->vertices.reserve(n);
+}
+
+/**
+ * @brief Add a vertex after the last one
+ * 
+ * @tparam T 
+ * @tparam U 
+ * @param p 
+ */
+template <typename T, typename U>
+void PolygonEditor<T, U>::addVertex(const Point2D<T, U>& p)
+{
+    this->vertices.push_back(p);
+}
+
+/**
+ * @brief Insert a vertex before the vertex at index i, or after the last one if i is the number of vertices
+ * 
+ * @tparam T 
+ * @tparam U 
+ * @param i 
+ * @param p 
+ */
+template <typename T, typename U>
+void PolygonEditor<T, U>::insertVertex(size_t i, const Point2D<T, U>& p)
+{
+    if (i > this->vertices.size())
+    {
+        throw out_of_range("Vertex index out of range");
+    }
+    this->vertices.insert(this->vertices.begin() + i, p);
+}
+
+/**
+ * @brief Remove the vertex at index i
+ * 
+ * @tparam T 
+ * @tparam U 
+ * @param i 
+ */
+template <typename T, typename U>
+void PolygonEditor<T, U>::removeVertex(size_t i)
+{
+    if (i >= this->vertices.size())
+    {
+        throw out_of_range("Vertex index out of range");
+    }
+    this->vertices.erase(this->vertices.begin() + i);
+}
+
+/**
+ * @brief Replace the vertex at index i
+ * 
+ * @tparam T 
+ * @tparam U 
+ * @param i 
+ * @param p 
+ */
+template <typename T, typename U>
+void PolygonEditor<T, U>::moveVertex(size_t i, const Point2D<T, U>& p)
+{
+    this->vertices.at(i) = p;
+}
+
+/**
+ * @brief Remove all the vertices
+ * 
+ * @tparam T 
+ * @tparam U 
+ */
+template <typename T, typename U>
+void PolygonEditor<T, U>::clear()
+{
+    this->vertices.clear();
+}
+
+/**
+ * @brief Apply the edits to the polygon. Throws an exception, leaving the polygon unchanged and the editor open, if the edited polygon intersects itself
+ * 
+ * @tparam T 
+ * @tparam U 
+ */
+template <typename T, typename U>
+void PolygonEditor<T, U>::commit()
+{
+    if (this->committed)
+    {
+        throw logic_error("The edits have already been committed");
+    }
+    this->polygon->setVertices(this->vertices);
+    this->committed = true;
+}
+
+/**
+ * @brief Check if the edits have been applied to the polygon
+ * 
+ * @tparam T 
+ * @tparam U 
+ * @return bool 
+ */
+template <typename T, typename U>
+bool PolygonEditor<T, U>::isCommitted() const
+{
+    return this->committed;
+}
+
 #endif // POLYGON_HPP
\ No newline at end of file
@@ -0,0 +1,238 @@
+/**
+ * @file rtree.hpp
+ * @author Bastien, Victor, AlexisR 
+ * @brief Header file for the RTree class
+ * @version 0.1
+ * @date 2024-01-16
+ * 
+ * @copyright Copyright (c) 2024
+ * 
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+#include "boundingbox.hpp"
+
+#ifndef RTREE_HPP
+#define RTREE_HPP
+
+using namespace std;
+
+/**
+ * @brief The RTree class is a static spatial index over bounding boxes, bulk-loaded with Sort-Tile-Recursive (STR) packing: the boxes are sorted by x, cut in vertical slices, sorted by y inside each slice and packed in full nodes, level after level.
+ * Every node is full except the last one of each level, so a query visits O(log n) nodes plus the ones overlapping the result
+ * 
+ */
+template <typename V>
+class RTree
+{
+    private:
+        static constexpr size_t NODE_CAPACITY = 16;
+
+        struct Entry
+        {
+            BoundingBox box;
+            V value;
+        };
+
+        /**
+         * @brief Children of a node are the entries [first, first + count) if it is a leaf, the nodes [first, first + count) otherwise
+         * 
+         */
+        struct Node
+        {
+            BoundingBox box;
+            uint32_t first;
+            uint32_t count;
+            bool leaf;
+        };
+
+        vector<Entry> entries;
+        vector<Node> nodes; // the root is the last node
+
+        template <typename Item>
+        static void sortTileRecursive(vector<Item>& items);
+        template <typename F>
+        void search(const Node& node, const BoundingBox& box, F& visit) const;
+    public:
+        RTree();
+        void build(vector<pair<BoundingBox, V>> items);
+        void clear();
+        size_t size() const;
+        template <typename F>
+        void search(const BoundingBox& box, F visit) const;
+        template <typename F>
+        void searchPoint(double x, double y, F visit) const;
+};
+
+/**
+ * @brief Construct a new empty RTree<V>::RTree object
+ * 
+ * @tparam V 
+ */
+template <typename V>
+RTree<V>::RTree()
+{
+}
+
+/**
+ * @brief Order items (anything with a box member) so that each run of NODE_CAPACITY items forms a compact node
+ * 
+ * @tparam V 
+ * @tparam Item 
+ * @param items 
+ */
+template <typename V>
+template <typename Item>
+void RTree<V>::sortTileRecursive(vector<Item>& items)
+{
+    size_t nodeCount = (items.size() + NODE_CAPACITY - 1) / NODE_CAPACITY;
+    size_t sliceCount = static_cast<size_t>(ceil(sqrt(static_cast<double>(nodeCount))));
+    size_t sliceSize = sliceCount * NODE_CAPACITY;
+    sort(items.begin(), items.end(), [](const Item& a, const Item& b) { return a.box.getCenterX() < b.box.getCenterX(); });
+    for (size_t start = 0; start < items.size(); start += sliceSize)
+    {
+        auto sliceEnd = items.begin() + min(start + sliceSize, items.size());
+        sort(items.begin() + start, sliceEnd, [](const Item& a, const Item& b) { return a.box.getCenterY() < b.box.getCenterY(); });
+    }
+}
+
+/**
+ * @brief Build the tree from all its items at once, replacing the previous content
+ * 
+ * @tparam V 
+ * @param items pairs of (bounding box, value)
+ */
+template <typename V>
+void RTree<V>::build(vector<pair<BoundingBox, V>> items)
+{
+    clear();
+    this->entries.reserve(items.size());
+    for (auto& item : items)
+    {
+        this->entries.push_back(Entry{item.first, item.second});
+    }
+    if (this->entries.empty())
+    {
+        return;
+    }
+
+    // leaves
+    sortTileRecursive(this->entries);
+    for (size_t i = 0; i < this->entries.size(); i += NODE_CAPACITY)
+    {
+        Node node{BoundingBox(), static_cast<uint32_t>(i), static_cast<uint32_t>(min(NODE_CAPACITY, this->entries.size() - i)), true};
+        for (size_t j = i; j < i + node.count; j++)
+        {
+            node.box.expand(this->entries[j].box);
+        }
+        this->nodes.push_back(node);
+    }
+
+    // upper levels, until a single root remains
+    size_t levelStart = 0;
+    while (this->nodes.size() - levelStart > 1)
+    {
+        vector<Node> level(this->nodes.begin() + levelStart, this->nodes.end());
+        this->nodes.resize(levelStart);
+        sortTileRecursive(level);
+        size_t childrenStart = this->nodes.size();
+        this->nodes.insert(this->nodes.end(), level.begin(), level.end());
+        levelStart = this->nodes.size();
+        for (size_t i = 0; i < level.size(); i += NODE_CAPACITY)
+        {
+            Node node{BoundingBox(), static_cast<uint32_t>(childrenStart + i), static_cast<uint32_t>(min(NODE_CAPACITY, level.size() - i)), false};
+            for (size_t j = i; j < i + node.count; j++)
+            {
+                node.box.expand(level[j].box);
+            }
+            this->nodes.push_back(node);
+        }
+    }
+}
+
+/**
+ * @brief Remove all the items
+ * 
+ * @tparam V 
+ */
+template <typename V>
+void RTree<V>::clear()
+{
+    this->entries.clear();
+    this->nodes.clear();
+}
+
+/**
+ * @brief Get the number of items
+ * 
+ * @tparam V 
+ * @return size_t 
+ */
+template <typename V>
+size_t RTree<V>::size() const
+{
+    return this->entries.size();
+}
+
+/**
+ * @brief Recursive part of search()
+ * 
+ */
+template <typename V>
+template <typename F>
+void RTree<V>::search(const Node& node, const BoundingBox& box, F& visit) const
+{
+    for (uint32_t i = node.first; i < node.first + node.count; i++)
+    {
+        if (node.leaf)
+        {
+            if (this->entries[i].box.intersects(box))
+            {
+                visit(this->entries[i].value);
+            }
+        }
+        else if (this->nodes[i].box.intersects(box))
+        {
+            search(this->nodes[i], box, visit);
+        }
+    }
+}
+
+/**
+ * @brief Call visit(value) for every item whose box intersects box
+ * 
+ * @tparam V 
+ * @tparam F 
+ * @param box 
+ * @param visit 
+ */
+template <typename V>
+template <typename F>
+void RTree<V>::search(const BoundingBox& box, F visit) const
+{
+    if (!this->nodes.empty() && this->nodes.back().box.intersects(box))
+    {
+        search(this->nodes.back(), box, visit);
+    }
+}
+
+/**
+ * @brief Call visit(value) for every item whose box contains the point (x, y)
+ * 
+ * @tparam V 
+ * @tparam F 
+ * @param x 
+ * @param y 
+ * @param visit 
+ */
+template <typename V>
+template <typename F>
+void RTree<V>::searchPoint(double x, double y, F visit) const
+{
+    search(BoundingBox(x, y, x, y), visit);
+}
+
+#endif // RTREE_HPP
@@ -0,0 +1,85 @@
+/**
+ * @file shoelace.hpp
+ * @author Bastien, Victor, AlexisR 
+ * @brief Header file for the exact arithmetic of the shoelace formula
+ * @version 0.1
+ * @date 2024-01-16
+ * 
+ * @copyright Copyright (c) 2024
+ * 
+ */
+
+#include <cmath>
+#include <cstdint>
+#include <type_traits>
+#include "point2d.hpp"
+
+#ifndef SHOELACE_HPP
+#define SHOELACE_HPP
+
+using namespace std;
+
+/**
+ * @brief The FixedPoint struct converts a coordinate to a 64-bit integer with FRACTION_BITS bits after the point.
+ * Floating point coordinates are rounded to 2^-20 unit (about a micrometer for coordinates in meters) and must stay below 2^43 in absolute value
+ * 
+ * @tparam V type of the coordinate
+ */
+template <typename V, bool Integral = is_integral<V>::value>
+struct FixedPoint
+{
+    static const int FRACTION_BITS = 20;
+    static int64_t convert(V v)
+    {
+        return llround(ldexp(static_cast<double>(v), FRACTION_BITS));
+    }
+};
+
+/**
+ * @brief Integral coordinates are used as they are, without any rounding
+ * 
+ */
+template <typename V>
+struct FixedPoint<V, true>
+{
+    static const int FRACTION_BITS = 0;
+    static int64_t convert(V v)
+    {
+        return static_cast<int64_t>(v);
+    }
+};
+
+/**
+ * @brief The Shoelace struct computes the terms of the shoelace formula in integers, so that a sum of terms is exact and the same in any order.
+ * With 32-bit integral coordinates a term needs 64 bits; the 128-bit accumulator leaves room for the sum, and for the fraction bits of floating point coordinates
+ * 
+ * @tparam T type of the x coordinate
+ * @tparam U type of the y coordinate
+ */
+template <typename T, typename U>
+struct Shoelace
+{
+    typedef __int128 Accumulator;
+    static const int FRACTION_BITS = FixedPoint<T>::FRACTION_BITS + FixedPoint<U>::FRACTION_BITS;
+
+    /**
+     * @brief Cross product of two vertices, i.e. one term of the shoelace formula, scaled by 2^FRACTION_BITS
+     *
+     */
+    static Accumulator cross(const Point2D<T, U>& a, const Point2D<T, U>& b)
+    {
+        return static_cast<Accumulator>(FixedPoint<T>::convert(a.getX())) * FixedPoint<U>::convert(b.getY())
+            - static_cast<Accumulator>(FixedPoint<U>::convert(a.getY())) * FixedPoint<T>::convert(b.getX());
+    }
+
+    /**
+     * @brief Convert a sum of terms back to a value in square units, rounded once
+     *
+     */
+    static double toDouble(Accumulator sum)
+    {
+        return ldexp(static_cast<double>(sum), -FRACTION_BITS);
+    }
+};
+
+#endif // SHOELACE_HPP
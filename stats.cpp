@@ -0,0 +1,279 @@
+/**
+ * @file stats.cpp
+ * @author Bastien, Victor, AlexisR 
+ * @brief Implementation file for the instrumentation counters and timers
+ * @version 0.1
+ * @date 2024-01-16
+ * 
+ * @copyright Copyright (c) 2024
+ * 
+ */
+
+#include <algorithm>
+#include <mutex>
+#include <vector>
+#include "stats.hpp"
+
+using namespace std;
+
+/**
+ * @brief The StatsRegistry struct knows the shards of the running threads, and keeps the counts of the threads that have exited
+ * 
+ */
+struct StatsRegistry
+{
+    mutex lock;
+    vector<StatsShard*> shards;
+    uint64_t counters[STATS_COUNTER_COUNT] = {};
+    uint64_t timerCalls[STATS_TIMER_COUNT] = {};
+    uint64_t timerNs[STATS_TIMER_COUNT] = {};
+};
+
+/**
+ * @brief Get the registry, never destroyed so that threads exiting late can still report to it
+ * 
+ */
+static StatsRegistry& getRegistry()
+{
+    static StatsRegistry* registry = new StatsRegistry();
+    return *registry;
+}
+
+/**
+ * @brief Construct a new StatsShard::StatsShard object with null counts, and register it
+ * 
+ */
+StatsShard::StatsShard()
+{
+    for (auto& value : this->counters) value = 0;
+    for (auto& value : this->timerCalls) value = 0;
+    for (auto& value : this->timerNs) value = 0;
+    StatsRegistry& registry = getRegistry();
+    lock_guard<mutex> guard(registry.lock);
+    registry.shards.push_back(this);
+}
+
+/**
+ * @brief Destroy the StatsShard::StatsShard object, keeping its counts in the registry
+ * 
+ */
+StatsShard::~StatsShard()
+{
+    StatsRegistry& registry = getRegistry();
+    lock_guard<mutex> guard(registry.lock);
+    for (int i = 0; i < STATS_COUNTER_COUNT; i++) registry.counters[i] += this->counters[i].load(memory_order_relaxed);
+    for (int i = 0; i < STATS_TIMER_COUNT; i++)
+    {
+        registry.timerCalls[i] += this->timerCalls[i].load(memory_order_relaxed);
+        registry.timerNs[i] += this->timerNs[i].load(memory_order_relaxed);
+    }
+    registry.shards.erase(remove(registry.shards.begin(), registry.shards.end(), this), registry.shards.end());
+}
+
+/**
+ * @brief Check if the library was compiled with the counters
+ * 
+ * @return bool
+ */
+bool Stats::isEnabled()
+{
+#ifdef CADASTRE_STATS
+    return true;
+#else
+    return false;
+#endif
+}
+
+/**
+ * @brief Get the value of a counter, summed over all the threads
+ * 
+ * @param counter
+ * @return uint64_t
+ */
+uint64_t Stats::get(StatsCounter counter)
+{
+    StatsRegistry& registry = getRegistry();
+    lock_guard<mutex> guard(registry.lock);
+    uint64_t total = registry.counters[counter];
+    for (auto shard : registry.shards)
+    {
+        total += shard->counters[counter].load(memory_order_relaxed);
+    }
+    return total;
+}
+
+/**
+ * @brief Get the number of calls to a timed operation
+ * 
+ * @param timer
+ * @return uint64_t
+ */
+uint64_t Stats::getCalls(StatsTimer timer)
+{
+    StatsRegistry& registry = getRegistry();
+    lock_guard<mutex> guard(registry.lock);
+    uint64_t total = registry.timerCalls[timer];
+    for (auto shard : registry.shards)
+    {
+        total += shard->timerCalls[timer].load(memory_order_relaxed);
+    }
+    return total;
+}
+
+/**
+ * @brief Get the total time spent in a timed operation
+ * 
+ * @param timer
+ * @return double in milliseconds
+ */
+double Stats::getMs(StatsTimer timer)
+{
+    StatsRegistry& registry = getRegistry();
+    lock_guard<mutex> guard(registry.lock);
+    uint64_t total = registry.timerNs[timer];
+    for (auto shard : registry.shards)
+    {
+        total += shard->timerNs[timer].load(memory_order_relaxed);
+    }
+    return total / 1e6;
+}
+
+/**
+ * @brief Set all the counters and timers back to 0. Counts made by other threads at the same time may be lost
+ * 
+ */
+void Stats::reset()
+{
+    StatsRegistry& registry = getRegistry();
+    lock_guard<mutex> guard(registry.lock);
+    fill(begin(registry.counters), end(registry.counters), 0);
+    fill(begin(registry.timerCalls), end(registry.timerCalls), 0);
+    fill(begin(registry.timerNs), end(registry.timerNs), 0);
+    for (auto shard : registry.shards)
+    {
+        for (auto& value : shard->counters) value.store(0, memory_order_relaxed);
+        for (auto& value : shard->timerCalls) value.store(0, memory_order_relaxed);
+        for (auto& value : shard->timerNs) value.store(0, memory_order_relaxed);
+    }
+}
+
+/**
+ * @brief Get the name of a counter, as used in the dumps
+ * 
+ * @param counter
+ * @return const char*
+ */
+const char* Stats::getName(StatsCounter counter)
+{
+    switch (counter)
+    {
+        case POLYGON_AREA_RECOMPUTATIONS: return "polygon_area_recomputations";
+        case PLOT_AREA_UPDATES: return "plot_area_updates";
+        case VERTEX_COPIES: return "vertex_copies";
+        case VERTICES_COPIED: return "vertices_copied";
+        case POLYGONS_CONSTRUCTED: return "polygons_constructed";
+        case POLYGONS_COPIED: return "polygons_copied";
+        case PLOTS_CONSTRUCTED: return "plots_constructed";
+        case PLOTS_COPIED: return "plots_copied";
+        case BYTES_ALLOCATED: return "bytes_allocated";
+        case ALLOCATIONS: return "allocations";
+        default: return "unknown";
+    }
+}
+
+/**
+ * @brief Get the name of a timer, as used in the dumps
+ * 
+ * @param timer
+ * @return const char*
+ */
+const char* Stats::getName(StatsTimer timer)
+{
+    switch (timer)
+    {
+        case LOAD_TEXT: return "load_text";
+        case LOAD_BINARY: return "load_binary";
+        case SAVE_TEXT: return "save_text";
+        case SAVE_BINARY: return "save_binary";
+        default: return "unknown";
+    }
+}
+
+/**
+ * @brief Print all the counters and timers, one per line
+ * 
+ * @param os
+ */
+void Stats::dumpText(ostream& os)
+{
+    if (!isEnabled())
+    {
+        os << "Statistics: disabled, compile with -DCADASTRE_STATS" << endl;
+        return;
+    }
+    os << "Statistics:" << endl;
+    for (int i = 0; i < STATS_COUNTER_COUNT; i++)
+    {
+        os << "\t" << getName(StatsCounter(i)) << ": " << get(StatsCounter(i)) << endl;
+    }
+    for (int i = 0; i < STATS_TIMER_COUNT; i++)
+    {
+        os << "\t" << getName(StatsTimer(i)) << ": " << getCalls(StatsTimer(i)) << " calls, " << getMs(StatsTimer(i)) << " ms" << endl;
+    }
+}
+
+/**
+ * @brief Print all the counters and timers as a JSON object
+ * 
+ * @param os
+ */
+void Stats::dumpJson(ostream& os)
+{
+    os << "{\"enabled\": " << (isEnabled() ? "true" : "false") << ", \"counters\": {";
+    for (int i = 0; i < STATS_COUNTER_COUNT; i++)
+    {
+        os << (i ? ", " : "") << "\"" << getName(StatsCounter(i)) << "\": " << get(StatsCounter(i));
+    }
+    os << "}, \"timers\": {";
+    for (int i = 0; i < STATS_TIMER_COUNT; i++)
+    {
+        os << (i ? ", " : "") << "\"" << getName(StatsTimer(i)) << "\": {\"calls\": " << getCalls(StatsTimer(i)) << ", \"ms\": " << getMs(StatsTimer(i)) << "}";
+    }
+    os << "}}" << endl;
+}
+
+/**
+ * @brief The CountingResource class allocates from the heap and counts the allocated bytes
+ * 
+ */
+class CountingResource : public pmr::memory_resource
+{
+    protected:
+        void* do_allocate(size_t bytes, size_t alignment) override
+        {
+            Stats::add(BYTES_ALLOCATED, bytes);
+            Stats::add(ALLOCATIONS, 1);
+            return pmr::new_delete_resource()->allocate(bytes, alignment);
+        }
+
+        void do_deallocate(void* p, size_t bytes, size_t alignment) override
+        {
+            pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+        }
+
+        bool do_is_equal(const pmr::memory_resource& other) const noexcept override
+        {
+            return this == &other;
+        }
+};
+
+/**
+ * @brief Get the memory resource used by default for the vertices of the polygons when the counters are enabled
+ * 
+ * @return pmr::memory_resource*
+ */
+pmr::memory_resource* Stats::getCountingResource()
+{
+    static CountingResource* resource = new CountingResource(); // never destroyed, static polygons may free their vertices after it
+    return resource;
+}
@@ -0,0 +1,152 @@
+/**
+ * @file stats.hpp
+ * @author Bastien, Victor, AlexisR 
+ * @brief Header file for the instrumentation counters and timers
+ * @version 0.1
+ * @date 2024-01-16
+ * 
+ * @copyright Copyright (c) 2024
+ * 
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <memory_resource>
+
+#ifndef STATS_HPP
+#define STATS_HPP
+
+using namespace std;
+
+/**
+ * @brief The StatsCounter enum lists what is counted
+ * 
+ */
+enum StatsCounter {
+    POLYGON_AREA_RECOMPUTATIONS, // full O(n) computations of the area of a polygon
+    PLOT_AREA_UPDATES, // calls to Plot::calculateArea()
+    VERTEX_COPIES, // calls to Polygon::getVertices()
+    VERTICES_COPIED, // vertices copied by Polygon::getVertices()
+    POLYGONS_CONSTRUCTED,
+    POLYGONS_COPIED,
+    PLOTS_CONSTRUCTED,
+    PLOTS_COPIED,
+    BYTES_ALLOCATED, // vertices of polygons on the heap and everything allocated in arenas
+    ALLOCATIONS, // number of allocations counted in BYTES_ALLOCATED
+    STATS_COUNTER_COUNT
+};
+
+/**
+ * @brief The StatsTimer enum lists what is timed
+ * 
+ */
+enum StatsTimer {
+    LOAD_TEXT,
+    LOAD_BINARY,
+    SAVE_TEXT,
+    SAVE_BINARY,
+    STATS_TIMER_COUNT
+};
+
+/**
+ * @brief The StatsShard struct holds the counters of one thread. Only its thread writes it, so an increment is a plain load and store, without a locked instruction
+ * 
+ */
+struct StatsShard
+{
+    atomic<uint64_t> counters[STATS_COUNTER_COUNT];
+    atomic<uint64_t> timerCalls[STATS_TIMER_COUNT];
+    atomic<uint64_t> timerNs[STATS_TIMER_COUNT];
+    StatsShard();
+    ~StatsShard();
+};
+
+/**
+ * @brief The Stats class gives access to the counters and timers, summed over all the threads.
+ * They are only updated when the library is compiled with CADASTRE_STATS defined; otherwise the STATS_ macros expand to nothing and every value reads 0
+ * 
+ */
+class Stats
+{
+    private:
+        /**
+         * @brief Get the counters of the calling thread, registered on first use and merged into the totals when the thread exits
+         *
+         * @return StatsShard&
+         */
+        static StatsShard& getShard()
+        {
+            thread_local StatsShard shard;
+            return shard;
+        }
+    public:
+        /**
+         * @brief Add n to a counter
+         *
+         * @param counter
+         * @param n
+         */
+        static void add(StatsCounter counter, uint64_t n)
+        {
+            atomic<uint64_t>& value = getShard().counters[counter];
+            value.store(value.load(memory_order_relaxed) + n, memory_order_relaxed);
+        }
+
+        /**
+         * @brief Record one call to a timed operation
+         *
+         * @param timer
+         * @param ns duration of the call in nanoseconds
+         */
+        static void addTime(StatsTimer timer, uint64_t ns)
+        {
+            StatsShard& shard = getShard();
+            shard.timerCalls[timer].store(shard.timerCalls[timer].load(memory_order_relaxed) + 1, memory_order_relaxed);
+            shard.timerNs[timer].store(shard.timerNs[timer].load(memory_order_relaxed) + ns, memory_order_relaxed);
+        }
+
+        static bool isEnabled();
+        static uint64_t get(StatsCounter counter);
+        static uint64_t getCalls(StatsTimer timer);
+        static double getMs(StatsTimer timer);
+        static void reset();
+        static const char* getName(StatsCounter counter);
+        static const char* getName(StatsTimer timer);
+        static void dumpText(ostream& os);
+        static void dumpJson(ostream& os);
+        static pmr::memory_resource* getCountingResource();
+};
+
+/**
+ * @brief The StatsTimerScope class times its own lifetime
+ * 
+ */
+class StatsTimerScope
+{
+    private:
+        StatsTimer timer;
+        chrono::steady_clock::time_point start;
+    public:
+        StatsTimerScope(StatsTimer timer) : timer(timer), start(chrono::steady_clock::now())
+        {
+        }
+        StatsTimerScope(const StatsTimerScope& s) = delete;
+        ~StatsTimerScope()
+        {
+            Stats::addTime(this->timer, chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - this->start).count());
+        }
+};
+
+#ifdef CADASTRE_STATS
+#define STATS_ADD(counter, n) Stats::add(counter, n)
+#define STATS_TIME(timer) StatsTimerScope statsTimerScope(timer)
+#define STATS_RESOURCE() Stats::getCountingResource()
+#else
+#define STATS_ADD(counter, n) ((void)0)
+#define STATS_TIME(timer) ((void)0)
+#define STATS_RESOURCE() pmr::get_default_resource()
+#endif
+
+#endif // STATS_HPP
@@ -0,0 +1,186 @@
+/**
+ * @file stringpool.cpp
+ * @author Bastien, Victor, AlexisR 
+ * @brief Implementation file for the StringPool class
+ * @version 0.1
+ * @date 2024-01-16
+ * 
+ * @copyright Copyright (c) 2024
+ * 
+ */
+
+#include <stdexcept>
+#include "stringpool.hpp"
+
+using namespace std;
+
+/**
+ * @brief Construct a new empty StringPool::StringPool object
+ * 
+ */
+StringPool::StringPool()
+{
+    for (auto& chunk : this->chunks)
+    {
+        chunk = nullptr;
+    }
+    this->count = 0;
+}
+
+/**
+ * @brief Destroy the StringPool::StringPool object and all its strings
+ * 
+ */
+StringPool::~StringPool()
+{
+    for (auto& chunk : this->chunks)
+    {
+        delete[] chunk.load();
+    }
+}
+
+/**
+ * @brief Find where a string is stored
+ * 
+ * @param id 
+ * @param chunk set to the chunk holding the string
+ * @param offset set to the position of the string in its chunk
+ */
+void StringPool::locate(uint32_t id, size_t& chunk, size_t& offset)
+{
+    size_t position = size_t(id) + FIRST_CHUNK_SIZE;
+    size_t bit = 63 - __builtin_clzll(position);
+    chunk = bit - 4; // log2(FIRST_CHUNK_SIZE)
+    offset = position - (size_t(1) << bit);
+}
+
+/**
+ * @brief Get the memory used by one stored string: its string object, its characters that do not fit in it, and its entry in the lookup table
+ * 
+ * @param s 
+ * @return size_t in bytes
+ */
+size_t StringPool::entrySize(const string& s)
+{
+    return sizeof(string) + (s.capacity() > 15 ? s.capacity() + 1 : 0) + sizeof(string_view) + sizeof(uint32_t) + 2 * sizeof(void*);
+}
+
+/**
+ * @brief Get the pool shared by all the plots
+ * 
+ * @return StringPool& 
+ */
+StringPool& StringPool::getInstance()
+{
+    static StringPool pool;
+    return pool;
+}
+
+/**
+ * @brief Get the number of a string, adding it to the pool the first time it is seen
+ * 
+ * @param s 
+ * @return uint32_t 
+ */
+uint32_t StringPool::intern(string_view s)
+{
+    lock_guard<mutex> guard(this->lock);
+    auto it = this->ids.find(s);
+    if (it != this->ids.end())
+    {
+        return it->second;
+    }
+    uint32_t id = this->count.load(memory_order_relaxed);
+    size_t index, offset;
+    locate(id, index, offset);
+    if (index >= MAX_CHUNKS)
+    {
+        throw runtime_error("The string pool is full");
+    }
+    string* chunk = this->chunks[index].load(memory_order_relaxed);
+    if (!chunk)
+    {
+        chunk = new string[FIRST_CHUNK_SIZE << index];
+        this->chunks[index].store(chunk, memory_order_release);
+    }
+    string& stored = chunk[offset];
+    stored.assign(s.data(), s.size());
+    this->ids.emplace(string_view(stored), id);
+    this->count.store(id + 1, memory_order_release);
+    return id;
+}
+
+/**
+ * @brief Get the number of a string already in the pool, without adding it
+ * 
+ * @param s 
+ * @param id set to the number of the string if it is found
+ * @return bool 
+ */
+bool StringPool::find(string_view s, uint32_t& id) const
+{
+    lock_guard<mutex> guard(this->lock);
+    auto it = this->ids.find(s);
+    if (it == this->ids.end())
+    {
+        return false;
+    }
+    id = it->second;
+    return true;
+}
+
+/**
+ * @brief Get a string from its number
+ * 
+ * @param id a number returned by intern()
+ * @return const string& 
+ */
+const string& StringPool::get(uint32_t id) const
+{
+    size_t index, offset;
+    locate(id, index, offset);
+    return this->chunks[index].load(memory_order_acquire)[offset];
+}
+
+/**
+ * @brief Get the number of distinct strings
+ * 
+ * @return size_t 
+ */
+size_t StringPool::size() const
+{
+    return this->count.load(memory_order_acquire);
+}
+
+/**
+ * @brief Get the memory used by the pool: the table of chunks, the allocated chunks, the characters of the strings that do not fit in a string object, and the lookup table
+ * 
+ * @return size_t in bytes
+ */
+size_t StringPool::getMemoryUsage() const
+{
+    lock_guard<mutex> guard(this->lock);
+    size_t chunkStrings = 0;
+    for (size_t i = 0; i < MAX_CHUNKS && this->chunks[i].load(memory_order_relaxed); i++)
+    {
+        chunkStrings += FIRST_CHUNK_SIZE << i;
+    }
+    size_t entries = 0;
+    for (uint32_t id = 0; id < this->count; id++)
+    {
+        entries += entrySize(get(id));
+    }
+    uint32_t unused = static_cast<uint32_t>(chunkStrings - this->count); // string objects allocated ahead in the last chunk
+    return sizeof(this->chunks) + entries + unused * sizeof(string) + this->ids.bucket_count() * sizeof(void*);
+}
+
+/**
+ * @brief Get the memory used by one string of the pool, see entrySize(). The memory shared by all the strings, such as the table of chunks, is not counted
+ * 
+ * @param id a number returned by intern()
+ * @return size_t in bytes
+ */
+size_t StringPool::getMemoryUsage(uint32_t id) const
+{
+    return entrySize(get(id));
+}
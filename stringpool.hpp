@@ -0,0 +1,56 @@
+/**
+ * @file stringpool.hpp
+ * @author Bastien, Victor, AlexisR 
+ * @brief Header file for the StringPool class
+ * @version 0.1
+ * @date 2024-01-16
+ * 
+ * @copyright Copyright (c) 2024
+ * 
+ */
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#ifndef STRINGPOOL_HPP
+#define STRINGPOOL_HPP
+
+using namespace std;
+
+/**
+ * @brief The StringPool class stores each distinct string once and identifies it by a number. Plots keep the numbers of their owner and crop type instead of their own copies of the strings.
+ * Strings are never removed nor moved, so get() does not lock: the strings are stored in chunks that are published once full-sized, and only intern() takes a lock.
+ * Chunk k holds FIRST_CHUNK_SIZE << k strings, so a few chunks cover every possible number
+ * 
+ */
+class StringPool
+{
+    private:
+        static constexpr size_t FIRST_CHUNK_SIZE = 16;
+        static constexpr size_t MAX_CHUNKS = 28;
+        atomic<string*> chunks[MAX_CHUNKS];
+        unordered_map<string_view, uint32_t> ids; // views into the stored strings
+        atomic<uint32_t> count;
+        mutable mutex lock;
+        static void locate(uint32_t id, size_t& chunk, size_t& offset);
+        static size_t entrySize(const string& s);
+    public:
+        StringPool();
+        StringPool(const StringPool& p) = delete;
+        StringPool& operator=(const StringPool& p) = delete;
+        ~StringPool();
+        static StringPool& getInstance();
+        uint32_t intern(string_view s);
+        bool find(string_view s, uint32_t& id) const;
+        const string& get(uint32_t id) const;
+        size_t size() const;
+        size_t getMemoryUsage() const;
+        size_t getMemoryUsage(uint32_t id) const;
+};
+
+#endif // STRINGPOOL_HPP
@@ -0,0 +1,396 @@
+/**
+ * @file textwriter.cpp
+ * @author Bastien, Victor, AlexisR 
+ * @brief Implementation file for the buffered writer of the text format
+ * @version 0.1
+ * @date 2024-01-16
+ * 
+ * @copyright Copyright (c) 2024
+ * 
+ */
+
+#include <cerrno>
+#include <charconv>
+#include <condition_variable>
+#include <cstring>
+#include <fcntl.h>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <unistd.h>
+#include "textwriter.hpp"
+#include "stats.hpp"
+
+using namespace std;
+
+// longest output of one field, with some margin: an int is at most 11 characters, a float as %g at most 13
+static const size_t MAX_NUMBER_SIZE = 16;
+static const size_t MAX_VERTEX_SIZE = 2 * MAX_NUMBER_SIZE + 4;
+
+/**
+ * @brief Construct a new TextBuffer::TextBuffer object
+ * 
+ * @param capacity initial size of the buffer in bytes, it grows as needed
+ */
+TextBuffer::TextBuffer(size_t capacity) : data(capacity), used(0)
+{
+}
+
+/**
+ * @brief Empty the buffer, keeping its memory for the next plots
+ * 
+ */
+void TextBuffer::clear()
+{
+    this->used = 0;
+}
+
+/**
+ * @brief Get the formatted text
+ * 
+ * @return const char* 
+ */
+const char* TextBuffer::getData() const
+{
+    return this->data.data();
+}
+
+/**
+ * @brief Get the size of the formatted text
+ * 
+ * @return size_t in bytes
+ */
+size_t TextBuffer::size() const
+{
+    return this->used;
+}
+
+/**
+ * @brief Make room for n more bytes
+ * 
+ * @return char* where to write them
+ */
+char* TextBuffer::reserve(size_t n)
+{
+    if (this->used + n > this->data.size())
+    {
+        this->data.resize(max(this->data.size() * 2, this->used + n));
+    }
+    return this->data.data() + this->used;
+}
+
+static char* writeInt(char* p, int value)
+{
+    return to_chars(p, p + MAX_NUMBER_SIZE, value).ptr;
+}
+
+static char* writeFloat(char* p, float value)
+{
+    return to_chars(p, p + MAX_NUMBER_SIZE, value, chars_format::general, 6).ptr;
+}
+
+static char* writeString(char* p, const string& s)
+{
+    memcpy(p, s.data(), s.size());
+    return p + s.size();
+}
+
+/**
+ * @brief Reserve room for a whole plot, then write its header line up to its type specific fields
+ * 
+ * @param plot 
+ * @param extra upper bound of the size of the type specific fields
+ * @return char* where to write the type specific fields
+ */
+char* TextBuffer::appendHeader(const Plot& plot, size_t extra)
+{
+    const string& owner = plot.getOwner();
+    char* p = reserve(8 + MAX_NUMBER_SIZE + owner.size() + extra + plot.getShape()->getVertexView().size() * MAX_VERTEX_SIZE);
+    p = writeString(p, PlotTypeToString(plot.getType()));
+    *p++ = ' ';
+    p = writeInt(p, plot.getNumber());
+    *p++ = ' ';
+    p = writeString(p, owner);
+    *p++ = ' ';
+    return p;
+}
+
+/**
+ * @brief Write the vertices line of a plot after its header, in the room reserved by appendHeader()
+ * 
+ * @param p end of the header
+ * @param plot 
+ */
+void TextBuffer::appendVertices(char* p, const Plot& plot)
+{
+    *p++ = '\n';
+    for (const auto& vertex : plot.getShape()->getVertexView())
+    {
+        *p++ = '[';
+        p = writeInt(p, vertex.getX());
+        *p++ = ';';
+        p = writeFloat(p, vertex.getY());
+        *p++ = ']';
+        *p++ = ' ';
+    }
+    *p++ = '\n';
+    this->used = p - this->data.data();
+}
+
+void TextBuffer::append(const UrbanZone& plot)
+{
+    char* p = appendHeader(plot, 2 * MAX_NUMBER_SIZE);
+    p = writeInt(p, plot.getPBuildable());
+    *p++ = ' ';
+    p = writeFloat(p, plot.getBuiltArea());
+    appendVertices(p, plot);
+}
+
+void TextBuffer::append(const ZoneToBeUrbanized& plot)
+{
+    char* p = appendHeader(plot, MAX_NUMBER_SIZE);
+    p = writeInt(p, plot.getPBuildable());
+    appendVertices(p, plot);
+}
+
+void TextBuffer::append(const NaturalAndForestZone& plot)
+{
+    appendVertices(appendHeader(plot, 0), plot);
+}
+
+void TextBuffer::append(const AgriculturalZone& plot)
+{
+    const string& cropType = plot.getCropType();
+    char* p = appendHeader(plot, cropType.size());
+    p = writeString(p, cropType);
+    appendVertices(p, plot);
+}
+
+/**
+ * @brief Append a plot whose class is only known at run time
+ * 
+ * @param plot 
+ */
+void TextBuffer::append(const Plot& plot)
+{
+    switch (plot.getType())
+    {
+        case PlotType::URBAN_ZONE:
+            append(dynamic_cast<const UrbanZone&>(plot));
+            break;
+        case PlotType::ZONE_TO_BE_URBANIZED:
+            append(dynamic_cast<const ZoneToBeUrbanized&>(plot));
+            break;
+        case PlotType::NATURAL_AND_FOREST_ZONE:
+            append(dynamic_cast<const NaturalAndForestZone&>(plot));
+            break;
+        case PlotType::AGRICULTURAL_ZONE:
+            append(dynamic_cast<const AgriculturalZone&>(plot));
+            break;
+    }
+}
+
+/**
+ * @brief Write a whole buffer, in as many calls to write() as the system needs
+ * 
+ * @return bool false on error
+ */
+static bool writeAll(int fd, const char* data, size_t size)
+{
+    while (size > 0)
+    {
+        ssize_t n = write(fd, data, size);
+        if (n < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            return false;
+        }
+        data += n;
+        size -= n;
+    }
+    return true;
+}
+
+/**
+ * @brief Format n plots by chunks and write the chunks in order. The chunks are formatted in parallel into a ring of reusable buffers, while the calling thread writes the finished ones;
+ * a chunk waits for its buffer to be written before reusing it, so the memory used does not grow with the number of plots
+ * 
+ * @param fd 
+ * @param n number of plots
+ * @param threadCount number of formatting threads, 0 for one per core
+ * @param format appends the plots [begin, end) to a buffer
+ * @return bool false if a write failed
+ */
+static bool writeChunks(int fd, size_t n, unsigned threadCount, const function<void(TextBuffer&, size_t, size_t)>& format)
+{
+    STATS_TIME(SAVE_TEXT);
+    const size_t chunkSize = 4096; // plots per chunk, i.e. a few hundred kilobytes per call to write()
+    size_t chunkCount = (n + chunkSize - 1) / chunkSize;
+    if (threadCount == 0)
+    {
+        threadCount = max(1u, thread::hardware_concurrency());
+    }
+    threadCount = static_cast<unsigned>(min<size_t>(threadCount, chunkCount));
+    if (threadCount <= 1)
+    {
+        TextBuffer buffer;
+        for (size_t c = 0; c < chunkCount; c++)
+        {
+            buffer.clear();
+            format(buffer, c * chunkSize, min(n, (c + 1) * chunkSize));
+            if (!writeAll(fd, buffer.getData(), buffer.size()))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    const size_t window = 2 * threadCount; // chunk c uses buffer c % window
+    vector<TextBuffer> buffers(window);
+    vector<bool> ready(window, false);
+    size_t written = 0;
+    bool failed = false;
+    mutex lock;
+    condition_variable changed;
+
+    auto formatChunks = [&](unsigned t) {
+        for (size_t c = t; c < chunkCount; c += threadCount)
+        {
+            {
+                unique_lock<mutex> guard(lock);
+                changed.wait(guard, [&]() { return failed || c < written + window; });
+                if (failed)
+                {
+                    return;
+                }
+            }
+            TextBuffer& buffer = buffers[c % window];
+            buffer.clear();
+            format(buffer, c * chunkSize, min(n, (c + 1) * chunkSize));
+            {
+                lock_guard<mutex> guard(lock);
+                ready[c % window] = true;
+            }
+            changed.notify_all();
+        }
+    };
+    vector<thread> workers;
+    for (unsigned t = 0; t < threadCount; t++)
+    {
+        workers.emplace_back(formatChunks, t);
+    }
+
+    for (size_t c = 0; c < chunkCount && !failed; c++)
+    {
+        {
+            unique_lock<mutex> guard(lock);
+            changed.wait(guard, [&]() { return ready[c % window]; });
+        }
+        bool ok = writeAll(fd, buffers[c % window].getData(), buffers[c % window].size());
+        {
+            lock_guard<mutex> guard(lock);
+            ready[c % window] = false;
+            written = c + 1;
+            failed = !ok;
+        }
+        changed.notify_all();
+    }
+    for (auto& worker : workers)
+    {
+        worker.join();
+    }
+    return !failed;
+}
+
+/**
+ * @brief Open a file for writing, replacing its content
+ * 
+ * @return int the file descriptor, -1 if the file cannot be opened
+ */
+static int openOutput(const string& filename)
+{
+    int fd = open(filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0)
+    {
+        cout << "Unable to open file" << endl;
+    }
+    return fd;
+}
+
+/**
+ * @brief Write the plots of a store in the text format, in file order, to an open file descriptor
+ * 
+ * @param store 
+ * @param fd 
+ * @param threadCount number of formatting threads, 0 for one per core
+ * @return bool false if a write failed
+ */
+bool writePlotsText(const PlotStore& store, int fd, unsigned threadCount)
+{
+    return writeChunks(fd, store.size(), threadCount, [&store](TextBuffer& buffer, size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++)
+        {
+            store.visitPlot(i, [&buffer](const auto& plot) { buffer.append(plot); });
+        }
+    });
+}
+
+/**
+ * @brief Write the plots of a store in the text format, in file order, to a file
+ * 
+ * @param store 
+ * @param filename 
+ * @param threadCount number of formatting threads, 0 for one per core
+ * @return bool false if the file cannot be opened or written
+ */
+bool writePlotsText(const PlotStore& store, const string& filename, unsigned threadCount)
+{
+    int fd = openOutput(filename);
+    if (fd < 0)
+    {
+        return false;
+    }
+    bool ok = writePlotsText(store, fd, threadCount);
+    return close(fd) == 0 && ok;
+}
+
+/**
+ * @brief Write plots in the text format to an open file descriptor
+ * 
+ * @param plots 
+ * @param fd 
+ * @param threadCount number of formatting threads, 0 for one per core
+ * @return bool false if a write failed
+ */
+bool writePlotsText(const vector<Plot*>& plots, int fd, unsigned threadCount)
+{
+    return writeChunks(fd, plots.size(), threadCount, [&plots](TextBuffer& buffer, size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++)
+        {
+            buffer.append(*plots[i]);
+        }
+    });
+}
+
+/**
+ * @brief Write plots in the text format to a file
+ * 
+ * @param plots 
+ * @param filename 
+ * @param threadCount number of formatting threads, 0 for one per core
+ * @return bool false if the file cannot be opened or written
+ */
+bool writePlotsText(const vector<Plot*>& plots, const string& filename, unsigned threadCount)
+{
+    int fd = openOutput(filename);
+    if (fd < 0)
+    {
+        return false;
+    }
+    bool ok = writePlotsText(plots, fd, threadCount);
+    return close(fd) == 0 && ok;
+}
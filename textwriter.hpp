@@ -0,0 +1,52 @@
+/**
+ * @file textwriter.hpp
+ * @author Bastien, Victor, AlexisR 
+ * @brief Header file for the buffered writer of the text format
+ * @version 0.1
+ * @date 2024-01-16
+ * 
+ * @copyright Copyright (c) 2024
+ * 
+ */
+
+#include <string>
+#include <vector>
+#include "plot.hpp"
+#include "plotstore.hpp"
+
+#ifndef TEXTWRITER_HPP
+#define TEXTWRITER_HPP
+
+using namespace std;
+
+/**
+ * @brief The TextBuffer class formats plots in the text format into a growing buffer, with to_chars instead of iostreams: no locale and no virtual call per field.
+ * Its output is byte for byte the same as writePlotText(); floats are written as %g with 6 significant digits, as ostream does by default
+ * 
+ */
+class TextBuffer
+{
+    private:
+        vector<char> data;
+        size_t used;
+        char* reserve(size_t n);
+        char* appendHeader(const Plot& plot, size_t extra);
+        void appendVertices(char* p, const Plot& plot);
+    public:
+        TextBuffer(size_t capacity = 1 << 20);
+        void clear();
+        const char* getData() const;
+        size_t size() const;
+        void append(const UrbanZone& plot);
+        void append(const ZoneToBeUrbanized& plot);
+        void append(const NaturalAndForestZone& plot);
+        void append(const AgriculturalZone& plot);
+        void append(const Plot& plot);
+};
+
+bool writePlotsText(const PlotStore& store, int fd, unsigned threadCount = 0);
+bool writePlotsText(const PlotStore& store, const string& filename, unsigned threadCount = 0);
+bool writePlotsText(const vector<Plot*>& plots, int fd, unsigned threadCount = 0);
+bool writePlotsText(const vector<Plot*>& plots, const string& filename, unsigned threadCount = 0);
+
+#endif // TEXTWRITER_HPP
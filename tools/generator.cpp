@@ -0,0 +1,416 @@
+/**
+ * @file generator.cpp
+ * @author Bastien, Victor, AlexisR 
+ * @brief Generator of large synthetic cadastres in the text format, for load and scale testing
+ * @version 0.1
+ * @date 2024-01-16
+ * 
+ * @copyright Copyright (c) 2024
+ * 
+ */
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+/**
+ * @brief The GeneratorOptions struct holds the settings of a generated cadastre
+ * 
+ */
+struct GeneratorOptions
+{
+    uint64_t plotCount = 1000;
+    uint64_t seed = 1;
+    int cellSize = 100; // side of a grid cell before jittering
+    double jitter = 0.2; // largest move of a grid node, as a fraction of the cell size
+    int minVertices = 4;
+    int maxVertices = 4;
+    double mix[4] = {25, 25, 25, 25}; // weights of ZU, ZAU, ZA and ZN
+    uint64_t ownerCount = 1000;
+    string output = "-";
+};
+
+/**
+ * @brief Mix bits of a 64 bits number (splitmix64 finalizer). Every random value of the generator is a hash of the seed and of what it is for, so the output depends neither on the order of generation nor on the platform
+ * 
+ * @param x
+ * @return uint64_t
+ */
+static uint64_t mix64(uint64_t x)
+{
+    x += 0x9e3779b97f4a7c15ull;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+    return x ^ (x >> 31);
+}
+
+/**
+ * @brief Get a random number from a seed, what it is drawn for and up to three keys
+ * 
+ */
+static uint64_t hashOf(uint64_t seed, uint64_t purpose, uint64_t a, uint64_t b = 0, uint64_t c = 0)
+{
+    return mix64(mix64(mix64(mix64(mix64(seed) ^ purpose) ^ a) ^ b) ^ c);
+}
+
+/**
+ * @brief Get a random number in [0, 1) from a hash
+ * 
+ */
+static double unit(uint64_t h)
+{
+    return (h >> 11) * (1.0 / 9007199254740992.0);
+}
+
+// what a hash is drawn for, so that two uses of the same keys do not get the same number
+enum Purpose : uint64_t { NODE_X = 1, NODE_Y, EDGE_COUNT, EDGE_OFFSET, PLOT_TYPE, PLOT_OWNER, PLOT_FIELD, PLOT_CROP };
+
+static const char* const FAMILY_NAMES[] = {"MARTIN", "BERNARD", "DUBOIS", "THOMAS", "ROBERT", "RICHARD", "PETIT", "DURAND", "LEROY", "MOREAU",
+    "SIMON", "LAURENT", "LEFEBVRE", "MICHEL", "GARCIA", "DAVID", "BERTRAND", "ROUX", "VINCENT", "FOURNIER", "MOREL", "GIRARD", "ANDRE", "MERCIER",
+    "BLANC", "GUERIN", "BOYER", "GARNIER", "CHEVALIER", "FRANCOIS", "LEGRAND", "GAUTHIER"};
+static const char* const CROPS[] = {"Blé", "Maïs", "Orge", "Colza", "Tournesol", "Tabac", "Vigne", "Betterave"};
+
+/**
+ * @brief The Generator class writes the plots of a jittered grid. The nodes of a regular grid are moved randomly, and every edge between two nodes gets a random number of extra vertices, offset randomly across the edge.
+ * A node or an edge is shared by the plots around it and its vertices only depend on its position in the grid, so neighbouring plots share their borders exactly and never overlap.
+ * The offsets of the extra vertices stay inside a thin diamond around the straight edge and the nodes move less than a quarter of a cell, so every plot is a simple polygon, written counterclockwise
+ * 
+ */
+class Generator
+{
+    private:
+        GeneratorOptions options;
+        uint64_t columns;
+        int minExtra; // extra vertices per edge
+        int maxExtra;
+        double mixTotal;
+        FILE* out;
+        vector<char> buffer;
+        size_t used;
+        string ownerName;
+
+        void flush()
+        {
+            fwrite(this->buffer.data(), 1, this->used, this->out);
+            this->used = 0;
+        }
+
+        void write(const char* s, size_t n)
+        {
+            if (this->used + n > this->buffer.size())
+            {
+                flush();
+            }
+            memcpy(this->buffer.data() + this->used, s, n);
+            this->used += n;
+        }
+
+        void write(const string& s)
+        {
+            write(s.data(), s.size());
+        }
+
+        void write(const char* s)
+        {
+            write(s, strlen(s));
+        }
+
+        template <typename N>
+        void writeNumber(N value)
+        {
+            char digits[32];
+            auto result = to_chars(digits, digits + sizeof(digits), value);
+            write(digits, result.ptr - digits);
+        }
+
+        /**
+         * @brief Get the position of the node (i, j) of the grid, in integer coordinates
+         *
+         */
+        void node(uint64_t i, uint64_t j, long& x, long& y) const
+        {
+            double range = this->options.jitter * this->options.cellSize;
+            x = lround(i * double(this->options.cellSize) + (2 * unit(hashOf(this->options.seed, NODE_X, i, j)) - 1) * range);
+            y = lround(j * double(this->options.cellSize) + (2 * unit(hashOf(this->options.seed, NODE_Y, i, j)) - 1) * range);
+        }
+
+        /**
+         * @brief Append the vertices of the edge from node (i, j) to its neighbour on the right (horizontal) or above (vertical), both nodes included
+         *
+         */
+        void edge(uint64_t i, uint64_t j, bool horizontal, vector<pair<long, long>>& points) const
+        {
+            long x0, y0, x1, y1;
+            node(i, j, x0, y0);
+            node(horizontal ? i + 1 : i, horizontal ? j : j + 1, x1, y1);
+            uint64_t key = (i << 1 | horizontal);
+            int extra = this->minExtra;
+            if (this->maxExtra > this->minExtra)
+            {
+                extra += hashOf(this->options.seed, EDGE_COUNT, key, j) % (this->maxExtra - this->minExtra + 1);
+            }
+            points.emplace_back(x0, y0);
+            double dx = x1 - x0, dy = y1 - y0;
+            for (int k = 1; k <= extra; k++)
+            {
+                double t = double(k) / (extra + 1);
+                // across the edge, at most a fifth of the distance to the nearest end of the edge
+                double offset = 0.2 * min(t, 1 - t) * (2 * unit(hashOf(this->options.seed, EDGE_OFFSET, key, j, k)) - 1);
+                points.emplace_back(lround(x0 + t * dx - offset * dy), lround(y0 + t * dy + offset * dx));
+            }
+            points.emplace_back(x1, y1);
+        }
+
+        /**
+         * @brief Write the plot of the cell (i, j)
+         *
+         */
+        void plot(uint64_t number, uint64_t i, uint64_t j, vector<pair<long, long>>& points, vector<pair<long, long>>& side)
+        {
+            uint64_t id = number;
+            double pick = unit(hashOf(this->options.seed, PLOT_TYPE, id)) * this->mixTotal;
+            int type = 0;
+            while (type < 3 && pick >= this->options.mix[type])
+            {
+                pick -= this->options.mix[type];
+                type++;
+            }
+            uint64_t owner = hashOf(this->options.seed, PLOT_OWNER, id) % this->options.ownerCount;
+            this->ownerName = FAMILY_NAMES[owner % 32];
+            if (owner >= 32)
+            {
+                this->ownerName += '-';
+                this->ownerName += to_string(owner / 32);
+            }
+            uint64_t field = hashOf(this->options.seed, PLOT_FIELD, id);
+            int pBuildable = static_cast<int>(field % 101);
+
+            // counterclockwise: bottom edge, right edge, then the top and left edges backwards
+            points.clear();
+            edge(i, j, true, side);
+            points.insert(points.end(), side.begin(), side.end() - 1);
+            side.clear();
+            edge(i + 1, j, false, side);
+            points.insert(points.end(), side.begin(), side.end() - 1);
+            side.clear();
+            edge(i, j + 1, true, side);
+            points.insert(points.end(), side.rbegin(), side.rend() - 1);
+            side.clear();
+            edge(i, j, false, side);
+            points.insert(points.end(), side.rbegin(), side.rend() - 1);
+            side.clear();
+
+            static const char* const TYPES[] = {"ZU ", "ZAU ", "ZA ", "ZN "};
+            write(TYPES[type]);
+            writeNumber(number);
+            write(" ");
+            write(this->ownerName);
+            write(" ");
+            switch (type)
+            {
+                case 0:
+                {
+                    // a built area from 1 m2 up to half the buildable part of the plot, whose area is computed from its jittered vertices,
+                    // never 0 so that every urban zone has a building; at least 1% must be buildable for the plot to pass validation
+                    int pUrban = max(pBuildable, 1);
+                    long long twiceArea = 0; // shoelace sum, exact on the integer vertices
+                    for (size_t k = 0; k < points.size(); k++)
+                    {
+                        const pair<long, long>& p = points[k];
+                        const pair<long, long>& q = points[(k + 1) % points.size()];
+                        twiceArea += static_cast<long long>(p.first) * q.second - static_cast<long long>(q.first) * p.second;
+                    }
+                    double area = twiceArea / 2.0;
+                    long built = 1 + static_cast<long>(unit(mix64(field)) * (area * pUrban / 100 / 2 - 1));
+                    writeNumber(pUrban);
+                    write(" ");
+                    writeNumber(built);
+                    break;
+                }
+                case 1:
+                    writeNumber(pBuildable);
+                    break;
+                case 2:
+                    write(CROPS[hashOf(this->options.seed, PLOT_CROP, id) % 8]);
+                    break;
+                default:
+                    break;
+            }
+            write("\n");
+            for (const auto& point : points)
+            {
+                write("[");
+                writeNumber(point.first);
+                write(";");
+                writeNumber(point.second);
+                write("] ");
+            }
+            write("\n");
+        }
+
+    public:
+        Generator(const GeneratorOptions& options) : options(options), buffer(1 << 20), used(0)
+        {
+            this->columns = static_cast<uint64_t>(ceil(sqrt(double(options.plotCount))));
+            this->minExtra = (options.minVertices - 4 + 3) / 4;
+            this->maxExtra = max(this->minExtra, (options.maxVertices - 4) / 4);
+            this->mixTotal = options.mix[0] + options.mix[1] + options.mix[2] + options.mix[3];
+            this->out = nullptr;
+        }
+
+        /**
+         * @brief Check the options, print the problem if any
+         *
+         * @return bool
+         */
+        bool check()
+        {
+            if (this->options.plotCount == 0 || this->options.ownerCount == 0 || this->mixTotal <= 0 || this->options.cellSize <= 0)
+            {
+                cerr << "Error: the plot count, owner count, cell size and mix must be positive" << endl;
+                return false;
+            }
+            if (this->options.jitter < 0 || this->options.jitter > 0.25)
+            {
+                cerr << "Error: the jitter must be between 0 and 0.25" << endl;
+                return false;
+            }
+            if (this->options.minVertices < 4 || this->options.maxVertices < this->options.minVertices)
+            {
+                cerr << "Error: the vertex counts must be at least 4, the maximum not below the minimum" << endl;
+                return false;
+            }
+            // keep the extra vertices at least 4 units apart, so that rounding them to integers cannot fold an edge
+            int minCell = 8 * (this->maxExtra + 1);
+            if (this->options.cellSize < minCell)
+            {
+                cerr << "Cell size raised to " << minCell << " to fit " << this->options.maxVertices << " vertices" << endl;
+                this->options.cellSize = minCell;
+            }
+            // y is read as a float, exact for integers up to 2^24
+            if ((this->columns + 1) * double(this->options.cellSize) >= double(1 << 24))
+            {
+                cerr << "Error: the map is too large for exact float coordinates, use a smaller cell size" << endl;
+                return false;
+            }
+            return true;
+        }
+
+        /**
+         * @brief Write the whole cadastre
+         *
+         * @return bool false if the output cannot be written
+         */
+        bool run()
+        {
+            bool toStdout = this->options.output == "-";
+            this->out = toStdout ? stdout : fopen(this->options.output.c_str(), "wb");
+            if (!this->out)
+            {
+                cout << "Unable to open file" << endl;
+                return false;
+            }
+            vector<pair<long, long>> points, side;
+            for (uint64_t n = 0; n < this->options.plotCount; n++)
+            {
+                plot(n + 1, n % this->columns, n / this->columns, points, side);
+            }
+            flush();
+            bool ok = !ferror(this->out);
+            if (!toStdout)
+            {
+                ok = fclose(this->out) == 0 && ok;
+            }
+            return ok;
+        }
+};
+
+/**
+ * @brief Print how to call the generator
+ * 
+ */
+static void usage(const char* program)
+{
+    cerr << "Usage: " << program << " [options] [output file, - for stdout]" << endl
+         << "  --plots N          number of plots, up to 10000000 (1000)" << endl
+         << "  --seed S           seed, the same seed and options give the same file (1)" << endl
+         << "  --vertices MIN:MAX vertex count of a plot, 4 plus a multiple of 4 as the extra vertices are drawn per shared edge (4:4)" << endl
+         << "  --mix ZU:ZAU:ZA:ZN weights of the zone types (25:25:25:25)" << endl
+         << "  --owners N         number of distinct owners (1000)" << endl
+         << "  --cell SIZE        side of a grid cell (100)" << endl
+         << "  --jitter F         largest move of a grid node, as a fraction of the cell (0.2)" << endl;
+}
+
+int main(int argc, char* argv[])
+{
+    GeneratorOptions options;
+    for (int i = 1; i < argc; i++)
+    {
+        string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--plots" && hasValue)
+        {
+            options.plotCount = strtoull(argv[++i], nullptr, 10);
+        }
+        else if (arg == "--seed" && hasValue)
+        {
+            options.seed = strtoull(argv[++i], nullptr, 10);
+        }
+        else if (arg == "--vertices" && hasValue)
+        {
+            if (sscanf(argv[++i], "%d:%d", &options.minVertices, &options.maxVertices) == 1)
+            {
+                options.maxVertices = options.minVertices;
+            }
+        }
+        else if (arg == "--mix" && hasValue)
+        {
+            if (sscanf(argv[++i], "%lf:%lf:%lf:%lf", &options.mix[0], &options.mix[1], &options.mix[2], &options.mix[3]) != 4)
+            {
+                usage(argv[0]);
+                return 1;
+            }
+        }
+        else if (arg == "--owners" && hasValue)
+        {
+            options.ownerCount = strtoull(argv[++i], nullptr, 10);
+        }
+        else if (arg == "--cell" && hasValue)
+        {
+            options.cellSize = atoi(argv[++i]);
+        }
+        else if (arg == "--jitter" && hasValue)
+        {
+            options.jitter = atof(argv[++i]);
+        }
+        else if (arg[0] != '-' || arg == "-")
+        {
+            options.output = arg;
+        }
+        else
+        {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if (options.plotCount > 10000000)
+    {
+        cerr << "Error: at most 10000000 plots" << endl;
+        return 1;
+    }
+    Generator generator(options);
+    if (!generator.check())
+    {
+        return 1;
+    }
+    return generator.run() ? 0 : 1;
+}
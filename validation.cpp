@@ -0,0 +1,144 @@
+/**
+ * @file validation.cpp
+ * @author Bastien, Victor, AlexisR 
+ * @brief Implementation file for the validation of the plots
+ * @version 0.1
+ * @date 2024-01-16
+ * 
+ * @copyright Copyright (c) 2024
+ * 
+ */
+
+#include <algorithm>
+#include <sstream>
+#include "validation.hpp"
+#include "workstealing.hpp"
+
+using namespace std;
+
+string PlotCheckToString(PlotCheck check) {
+    switch(check) {
+        case NULL_AREA: return "null area";
+        case CLOCKWISE: return "clockwise";
+        case SELF_INTERSECTION: return "self-intersection";
+        case INVALID_BUILDABLE_PERCENTAGE: return "invalid buildable percentage";
+        case BUILT_AREA_TOO_LARGE: return "built area too large";
+        default: return "Unknown";
+    }
+}
+
+/**
+ * @brief Check if no plot broke any rule
+ * 
+ * @return bool 
+ */
+bool ValidationReport::isValid() const
+{
+    return this->errors.empty();
+}
+
+/**
+ * @brief Count the plots breaking a rule
+ * 
+ * @param check 
+ * @return size_t 
+ */
+size_t ValidationReport::count(PlotCheck check) const
+{
+    return count_if(this->errors.begin(), this->errors.end(), [check](const PlotError& e) { return e.check == check; });
+}
+
+/**
+ * @brief Overload of the << operator for printing a validation report, one error per line
+ * 
+ * @param os 
+ * @param r 
+ * @return ostream& 
+ */
+ostream& operator<<(ostream& os, const ValidationReport& r)
+{
+    os << "Validation: " << r.plotCount << " plots, " << r.invalidPlotCount << " invalid" << endl;
+    for (const auto& error : r.errors)
+    {
+        os << "\tPlot " << error.number << ": " << PlotCheckToString(error.check) << ": " << error.message << endl;
+    }
+    return os;
+}
+
+/**
+ * @brief Check all the rules on one plot
+ * 
+ */
+static void checkPlot(const Plot& plot, size_t index, vector<PlotError>& errors)
+{
+    auto fail = [&](PlotCheck check, const string& message) { errors.push_back(PlotError{index, plot.getNumber(), check, message}); };
+    const Polygon<int, float>* shape = plot.getShape();
+    VertexView<int, float> vertices = shape->getVertexView();
+    Shoelace<int, float>::Accumulator twiceArea = shape->getTwiceArea();
+    bool validArea = vertices.size() >= 3 && twiceArea > 0;
+    if (vertices.size() < 3 || twiceArea == 0)
+    {
+        fail(NULL_AREA, "The area of the polygon is null (" + to_string(vertices.size()) + " vertices)");
+    }
+    else if (twiceArea < 0)
+    {
+        fail(CLOCKWISE, "The vertices are in clockwise order");
+    }
+    size_t first, second; // a polygon built through a checked constructor is already known not to intersect itself
+    if (vertices.size() >= 3 && !shape->isValidated() && findSelfIntersection(vertices.data(), vertices.size(), first, second))
+    {
+        fail(SELF_INTERSECTION, "Edges " + to_string(first) + " and " + to_string(second) + " intersect");
+    }
+    if (plot.getType() != PlotType::NATURAL_AND_FOREST_ZONE && (plot.getPBuildable() < 0 || plot.getPBuildable() > 100))
+    {
+        fail(INVALID_BUILDABLE_PERCENTAGE, "The buildable area is " + to_string(plot.getPBuildable()) + "% of the plot");
+    }
+    if (plot.getType() == PlotType::URBAN_ZONE && validArea)
+    {
+        float builtArea = dynamic_cast<const UrbanZone&>(plot).getBuiltArea();
+        float maxBuiltArea = plot.getArea() * (static_cast<float>(plot.getPBuildable()) / 100.0f); // as in UrbanZone
+        if (builtArea < 0 || builtArea > maxBuiltArea)
+        {
+            ostringstream message;
+            message << "The built area is " << builtArea << " m2, " << maxBuiltArea << " m2 allowed";
+            fail(BUILT_AREA_TOO_LARGE, message.str());
+        }
+    }
+}
+
+/**
+ * @brief Check every plot against the rules of PlotCheck, on a work-stealing pool: a thread held up by a large polygon has its remaining plots taken by the others.
+ * Nothing is printed; the errors are returned in a report that does not depend on the number of threads
+ * 
+ * @param plots 
+ * @param count number of plots
+ * @param threadCount number of threads, 0 for one per core
+ * @return ValidationReport 
+ */
+ValidationReport validatePlots(const Plot* const* plots, size_t count, unsigned threadCount)
+{
+    WorkStealingPool pool(threadCount);
+    vector<vector<PlotError>> found(pool.getThreadCount());
+    const size_t grain = 64; // plots per range that is not split any more
+    pool.run(count, grain, [&](size_t i, unsigned worker) {
+        checkPlot(*plots[i], i, found[worker]);
+    });
+
+    ValidationReport report;
+    report.plotCount = count;
+    for (auto& errors : found)
+    {
+        report.errors.insert(report.errors.end(), make_move_iterator(errors.begin()), make_move_iterator(errors.end()));
+    }
+    sort(report.errors.begin(), report.errors.end(), [](const PlotError& a, const PlotError& b) {
+        return a.index != b.index ? a.index < b.index : a.check < b.check;
+    });
+    for (size_t i = 0; i < report.errors.size(); i++)
+    {
+        if (i == 0 || report.errors[i].index != report.errors[i-1].index)
+        {
+            report.invalidPlotCount++;
+        }
+    }
+    return report;
+}
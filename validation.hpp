@@ -0,0 +1,71 @@
+/**
+ * @file validation.hpp
+ * @author Bastien, Victor, AlexisR 
+ * @brief Header file for the validation of the plots
+ * @version 0.1
+ * @date 2024-01-16
+ * 
+ * @copyright Copyright (c) 2024
+ * 
+ */
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include "plot.hpp"
+
+#ifndef VALIDATION_HPP
+#define VALIDATION_HPP
+
+using namespace std;
+
+/**
+ * @brief The PlotCheck enum lists the rules a plot must follow
+ * 
+ */
+enum PlotCheck {
+    NULL_AREA, // the shape has fewer than 3 vertices or a null area
+    CLOCKWISE, // the vertices must be in counterclockwise order
+    SELF_INTERSECTION, // two edges of the shape intersect
+    INVALID_BUILDABLE_PERCENTAGE, // the percentage of buildable area of ZU, ZAU and ZA is outside [0, 100]
+    BUILT_AREA_TOO_LARGE // the built area of a ZU is negative or above its buildable area
+};
+
+/**
+ * @brief Convert a PlotCheck to a string for printing
+ * 
+ * @param check 
+ * @return string 
+ */
+string PlotCheckToString(PlotCheck check);
+
+/**
+ * @brief The PlotError struct is a rule broken by a plot
+ * 
+ */
+struct PlotError
+{
+    size_t index; // position of the plot in the list that was validated
+    int number;
+    PlotCheck check;
+    string message;
+};
+
+/**
+ * @brief The ValidationReport struct holds the errors of a list of plots, ordered by position of the plot, then by rule, whatever the threads that found them
+ * 
+ */
+struct ValidationReport
+{
+    size_t plotCount = 0;
+    size_t invalidPlotCount = 0;
+    vector<PlotError> errors;
+    bool isValid() const;
+    size_t count(PlotCheck check) const;
+};
+
+ostream& operator<<(ostream& os, const ValidationReport& r);
+
+ValidationReport validatePlots(const Plot* const* plots, size_t count, unsigned threadCount = 0);
+
+#endif // VALIDATION_HPP
@@ -0,0 +1,175 @@
+/**
+ * @file workstealing.hpp
+ * @author Bastien, Victor, AlexisR 
+ * @brief Header file for the WorkStealingPool class
+ * @version 0.1
+ * @date 2024-01-16
+ * 
+ * @copyright Copyright (c) 2024
+ * 
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#ifndef WORKSTEALING_HPP
+#define WORKSTEALING_HPP
+
+using namespace std;
+
+/**
+ * @brief The WorkStealingPool class runs a loop over n items on several threads. Each thread starts with an equal slice of the items, kept as ranges in its own deque.
+ * A thread splits its ranges in halves down to the grain size and works from the back of its deque; a thread that runs out of work steals the largest range at the front of another deque.
+ * So a thread held up by an expensive item, e.g. a large polygon, does not keep the items after it waiting: the other threads take them
+ * 
+ */
+class WorkStealingPool
+{
+    private:
+        /**
+         * @brief The ranges of items waiting to be processed by one thread
+         * 
+         */
+        struct WorkQueue
+        {
+            mutex lock;
+            deque<pair<size_t, size_t>> ranges;
+        };
+        unsigned threadCount;
+        atomic<size_t> steals;
+        static bool pop(WorkQueue& queue, pair<size_t, size_t>& range, bool back);
+    public:
+        WorkStealingPool(unsigned threadCount = 0);
+        unsigned getThreadCount() const;
+        size_t getStealCount() const;
+        template <typename F>
+        void run(size_t n, size_t grain, F body);
+};
+
+/**
+ * @brief Construct a new WorkStealingPool::WorkStealingPool object
+ * 
+ * @param threadCount number of threads, 0 for one per core
+ */
+inline WorkStealingPool::WorkStealingPool(unsigned threadCount) : threadCount(threadCount ? threadCount : max(1u, thread::hardware_concurrency())), steals(0)
+{
+}
+
+/**
+ * @brief Get the number of threads running the loops
+ * 
+ * @return unsigned 
+ */
+inline unsigned WorkStealingPool::getThreadCount() const
+{
+    return this->threadCount;
+}
+
+/**
+ * @brief Get the number of ranges taken by a thread from the deque of another, since the pool was created
+ * 
+ * @return size_t 
+ */
+inline size_t WorkStealingPool::getStealCount() const
+{
+    return this->steals.load();
+}
+
+/**
+ * @brief Take a range from the back (owner) or the front (thief) of a deque
+ * 
+ * @return bool false if the deque is empty
+ */
+inline bool WorkStealingPool::pop(WorkQueue& queue, pair<size_t, size_t>& range, bool back)
+{
+    lock_guard<mutex> guard(queue.lock);
+    if (queue.ranges.empty())
+    {
+        return false;
+    }
+    if (back)
+    {
+        range = queue.ranges.back();
+        queue.ranges.pop_back();
+    }
+    else
+    {
+        range = queue.ranges.front();
+        queue.ranges.pop_front();
+    }
+    return true;
+}
+
+/**
+ * @brief Call body(i, worker) for every i in [0, n), worker being the number of the calling thread, below getThreadCount(). Returns once all the items are processed.
+ * The threads are started for this call and joined before it returns; the calling thread is worker 0
+ * 
+ * @tparam F 
+ * @param n number of items
+ * @param grain ranges of this many items or less are not split any more
+ * @param body 
+ */
+template <typename F>
+void WorkStealingPool::run(size_t n, size_t grain, F body)
+{
+    unsigned workers = static_cast<unsigned>(min<size_t>(this->threadCount, max<size_t>(n, 1)));
+    grain = max<size_t>(grain, 1);
+    vector<unique_ptr<WorkQueue>> queues;
+    for (unsigned w = 0; w < workers; w++)
+    {
+        queues.push_back(make_unique<WorkQueue>());
+        queues[w]->ranges.push_back(make_pair(n * w / workers, n * (w + 1) / workers));
+    }
+    atomic<size_t> remaining(n);
+
+    auto work = [&](unsigned w) {
+        pair<size_t, size_t> range;
+        while (remaining.load() > 0)
+        {
+            bool found = pop(*queues[w], range, true);
+            for (unsigned k = 1; !found && k < workers; k++)
+            {
+                found = pop(*queues[(w + k) % workers], range, false);
+                if (found)
+                {
+                    this->steals++;
+                }
+            }
+            if (!found)
+            {
+                this_thread::yield(); // the last ranges are being processed
+                continue;
+            }
+            while (range.second - range.first > grain)
+            {
+                size_t middle = range.first + (range.second - range.first) / 2;
+                lock_guard<mutex> guard(queues[w]->lock);
+                queues[w]->ranges.push_back(make_pair(middle, range.second));
+                range.second = middle;
+            }
+            for (size_t i = range.first; i < range.second; i++)
+            {
+                body(i, w);
+            }
+            remaining -= range.second - range.first;
+        }
+    };
+
+    vector<thread> threads;
+    for (unsigned w = 1; w < workers; w++)
+    {
+        threads.emplace_back(work, w);
+    }
+    work(0);
+    for (auto& t : threads)
+    {
+        t.join();
+    }
+}
+
+#endif // WORKSTEALING_HPP